@@ -19,6 +19,9 @@ public:
 
     // 开始生成动画（新方块弹出）
     void startSpawnAnimation(int row, int col, int value);
+    
+    // 倒放移动动画（撤销用）：events 为正向移动的事件，方块从终点滑回起点，合并的方块重新分开
+    void startReverseMoveAnimation(const std::vector<MoveEvent>& events);
 
     // 每帧更新动画（deltaTime: 秒）
     void update(float deltaTime);
@@ -37,6 +40,15 @@ public:
 
     // 可选：手动停止动画（调试/切场景用）
     void stop();
+    
+    // 回放倍速：动画时间按倍数加速，使一步动画正好占满 1/movesPerSecond 秒；
+    // 每秒步数超过显示帧率时跳过插值（start* 不再产生动画，调用方直接显示结果）
+    void setPlaybackRate(float movesPerSecond, float displayRate);
+    void resetPlaybackRate();
+    bool isSkippingInterpolation() const;
+    
+    // 正常速度下每秒可播放的步数（移动 + 合并 + 生成动画各一次）
+    float baseMovesPerSecond() const;
 
 private:
     std::vector<VisualTile> visualTiles_;
@@ -47,6 +59,8 @@ private:
     float moveDuration_;   // 移动动画时长（秒）
     float mergeDuration_;  // 合并弹出动画时长（秒）
     float spawnDuration_;  // 生成弹出动画时长（秒）
+    float timeScale_;      // 动画时间倍数（回放加速）
+    bool skipInterpolation_;  // 播放速度超过帧率，不做插值
 
     float cellSize_;
     float padding_;
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <utility>
+#include <cstdint>
 
 enum class Direction {
     UP,
@@ -22,8 +23,9 @@ class Board {
 public:
     Board();
     
-    // 初始化新游戏（生成两个初始方块）
+    // 初始化新游戏（生成两个初始方块），不指定种子时随机取一个
     void init();
+    void init(uint64_t seed);
     
     // 获取当前网格
     void getGrid(int outGrid[4][4]) const;
@@ -44,9 +46,50 @@ public:
     // 返回生成的位置和值
     std::pair<std::pair<int, int>, int> spawnNewTile();
     
+    // 在指定空格放置方块（困难模式由生成器决定位置和数值，不消耗随机数）；不是空格返回false
+    bool placeTile(int row, int col, int value);
+    
+    // 完整执行一步（移动、加分、生成新方块），无效移动返回false；回放和离线分析用
+    bool applyMove(Direction dir);
+    
+    // 随机数状态：每个Board独立，相同状态下之后生成的方块完全相同（回放只需记录初始状态）
+    void seed(uint64_t seed);
+    uint64_t getRngState() const;
+    void setRngState(uint64_t state);
+    static uint64_t randomSeed();
+    
+    // 随机数状态每次生成方块前进固定步长：求 from 经过几次生成到达 to，以及反过来推进
+    static uint64_t rngDistance(uint64_t from, uint64_t to);
+    static uint64_t rngAdvance(uint64_t state, uint64_t draws);
+    
+    // 紧凑表示：16格 x 4位（log2，0为空），行优先，第 row*4+col 格在第 4*(row*4+col) 位
+    // 方块超过32768时无法表示，返回false
+    bool pack(uint64_t& packed) const;
+    void unpack(uint64_t packed);
+    
+    // Zobrist 哈希：网格变化时只对变化的格子异或更新（生成方块 O(1)，移动 O(16)）
+    uint64_t hash() const { return hash_; }
+    static uint64_t hashOf(uint64_t packed);  // 由紧凑表示直接计算，与 hash() 一致
+    
+    // 二面体对称（4种旋转 x 翻转）：在紧凑表示上用位运算变换
+    static uint64_t transpose(uint64_t packed);   // 沿主对角线翻转
+    static uint64_t mirror(uint64_t packed);      // 左右翻转
+    static uint64_t flip(uint64_t packed);        // 上下翻转
+    
+    // 规范形式：8种对称局面中紧凑值最小的一个，等价局面得到同一个值（可直接作置换表的键）
+    static uint64_t canonical(uint64_t packed);
+    
+    // 在紧凑表示上直接移动（查65536项的行表），比 simulateMove 快得多，供AI搜索和训练使用；
+    // 返回移动后的局面（与输入相同表示无效移动），两个32768不再合并
+    static uint64_t movePacked(uint64_t packed, Direction dir, int* scoreGain = nullptr);
+    static int emptyCount(uint64_t packed);
+    // 紧凑表示上生成新方块，与 spawnNewTile 使用同样的随机数规则（相同状态生成相同方块）
+    static uint64_t spawnPacked(uint64_t packed, uint64_t& rngState);
+    
     // 检查游戏状态
     bool hasWon() const;        // 是否出现2048
     bool isGameOver() const;    // 是否无法移动
+    int getMaxTile() const;     // 当前最大方块
     
     // 分数管理
     int getScore() const;
@@ -56,6 +99,13 @@ public:
 private:
     int grid_[4][4];
     int score_;
+    uint64_t rngState_;
+    uint64_t hash_;
+    
+    void rehash();
+    
+    // splitmix64：状态只有一个64位整数，便于存档和回放
+    uint64_t nextRandom();
     
     // 辅助函数
     void moveLeft(int tempGrid[4][4], int& scoreGain) const;
@@ -64,7 +114,7 @@ private:
     void moveDown(int tempGrid[4][4], int& scoreGain) const;
     
     bool canMove() const;
-    std::vector<std::pair<int, int>> getEmptyCells() const;
+    int getEmptyCells(int cells[16]) const;  // 空格下标（row * 4 + col），返回个数
     void copyGrid(const int src[4][4], int dst[4][4]) const;
     bool gridEquals(const int grid1[4][4], const int grid2[4][4]) const;
 };
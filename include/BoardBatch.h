@@ -0,0 +1,54 @@
+#ifndef BOARDBATCH_H
+#define BOARDBATCH_H
+
+#include "Board.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 批量移动的实现：运行时按CPU支持的指令集选择
+enum class BatchKernel {
+    SCALAR,
+    SSE41,   // 每次16个局面
+    AVX2     // 每次32个局面
+};
+
+// 一批局面按数组结构存放：第 i 格（row*4+col）的所有局面连续，cell(i)[k] 是第 k 个局面该格的 log2 值
+// 同一方向的移动对所有局面同时进行，合并判断和得分都在向量通道里完成，没有按局面的分支
+class BoardBatch {
+public:
+    static const size_t LANE_ALIGN = 32;   // 局面数按32补齐，补齐的局面为空盘
+    
+    explicit BoardBatch(size_t count = 0);
+    
+    void resize(size_t count);
+    size_t size() const { return size_; }
+    
+    // 与 Board::pack 相同的紧凑表示互相转换
+    void set(size_t index, uint64_t packed);
+    uint64_t get(size_t index) const;
+    
+    uint8_t* cell(int i) { return &cells_[i * stride_]; }
+    const uint8_t* cell(int i) const { return &cells_[i * stride_]; }
+    
+    // 所有局面执行同一方向的移动（原地修改）；返回有变化的局面数
+    size_t move(Direction dir);
+    size_t move(Direction dir, BatchKernel kernel);
+    
+    // 最近一次 move 中第 k 个局面的得分和是否有变化
+    uint32_t gain(size_t index) const { return gains_[index]; }
+    bool changed(size_t index) const { return changed_[index] != 0; }
+    
+    static BatchKernel bestKernel();
+    static bool isSupported(BatchKernel kernel);
+    static const char* kernelName(BatchKernel kernel);
+
+private:
+    size_t size_;
+    size_t stride_;
+    std::vector<uint8_t> cells_;     // 16 x stride_
+    std::vector<uint32_t> gains_;    // stride_
+    std::vector<uint8_t> changed_;   // stride_
+};
+
+#endif // BOARDBATCH_H
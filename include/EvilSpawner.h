@@ -0,0 +1,62 @@
+#ifndef EVILSPAWNER_H
+#define EVILSPAWNER_H
+
+#include "Board.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// 一次生成选择：格子下标（row*4+col）和数值（2或4）
+struct SpawnChoice {
+    int cell;
+    int value;
+    int depth;   // 得出该选择的搜索深度（后台一层都没完成时为当场搜索的1层）
+};
+
+// 困难模式的生成器：选择对玩家最不利的格子和数值
+// 极小极大搜索（生成方取最小、玩家取最大，alpha-beta 剪枝），迭代加深：
+// 每完成一层就更新当前最佳选择，时间到或被取走时放弃未完成的一层
+// 玩家移动一开始就提交移动后的局面，搜索（共享任务系统的高优先级任务）与移动动画同时进行，生成方块时直接取结果，不必等待
+class EvilSpawner {
+public:
+    static const int DEFAULT_BUDGET_MS = 150;   // 短于移动动画（0.2秒）
+    static const int MAX_DEPTH = 8;
+    
+    explicit EvilSpawner(JobSystem& jobs);
+    ~EvilSpawner();
+    
+    EvilSpawner(const EvilSpawner&) = delete;
+    EvilSpawner& operator=(const EvilSpawner&) = delete;
+    
+    void setTimeBudget(int milliseconds);
+    
+    // 提交玩家移动后的局面（紧凑表示），后台开始搜索
+    void request(uint64_t afterstate);
+    
+    // 立即取该局面的最佳选择并停止搜索；一层都没完成时当场做一层静态估值（几十个节点）
+    // 局面已满返回false
+    bool take(uint64_t afterstate, SpawnChoice& choice);
+    
+    void cancel();
+    
+    // 同步搜索到指定深度（工具和测试用）
+    static bool search(uint64_t afterstate, int depth, SpawnChoice& choice);
+
+private:
+    std::atomic<int> budgetMs_;
+    
+    std::mutex mutex_;
+    uint32_t requestGeneration_; // 最新请求的编号，被取代、取走或取消时加一
+    uint64_t resultBoard_;       // 当前结果对应的局面
+    bool hasResult_;
+    SpawnChoice result_;
+    std::atomic<bool> cancelled_;
+    
+    JobStrand strand_;           // 最后一个成员：析构时最先等待未完成的任务
+    
+    void runSearch(uint64_t board, uint32_t generation);
+};
+
+#endif // EVILSPAWNER_H
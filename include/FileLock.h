@@ -0,0 +1,19 @@
+#ifndef FILELOCK_H
+#define FILELOCK_H
+
+#include <string>
+
+// 跨进程咨询锁（flock），析构时释放；多个kiosk实例共享同一份数据文件时使用
+class FileLock {
+public:
+    FileLock(const std::string& path, bool exclusive);
+    ~FileLock();
+    
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    
+private:
+    int fd_;
+};
+
+#endif // FILELOCK_H
@@ -0,0 +1,40 @@
+#ifndef FRAME_SNAPSHOT_H
+#define FRAME_SNAPSHOT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "HintSearch.h"
+#include "Menu.h"
+#include "MoveEvent.h"
+#include "RankList.h"
+
+// 要绘制的界面
+enum class FrameScreen {
+    MENU,       // 主菜单
+    RANK_LIST,  // 排行榜
+    BOARD       // 棋盘（游戏中、胜利、结束、回放）
+};
+
+// 一帧的全部绘制数据：逻辑线程写好后整份发布，渲染线程只读，不访问 Game 的任何成员
+// 放在三缓冲中循环使用，字符串和数组的容量保留下来，稳定后每帧不再分配内存
+struct FrameSnapshot {
+    FrameScreen screen = FrameScreen::MENU;
+    
+    // 棋盘界面
+    Board board;
+    std::vector<VisualTile> tiles;  // 动画中的方块
+    std::string username;
+    int bestScore = 0;
+    std::string statusText;
+    std::string detailText;
+    bool hasHint = false;
+    Hint hint = {};
+    
+    // 菜单和排行榜界面
+    MenuView menu;
+    std::shared_ptr<const RankSnapshot> ranks;  // 排行榜快照本身不可变，直接共享
+};
+
+#endif // FRAME_SNAPSHOT_H
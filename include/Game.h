@@ -2,20 +2,47 @@
 #define GAME_H
 
 #include <SFML/Graphics.hpp>
+#include <atomic>
 #include <string>
+#include <thread>
 #include "Board.h"
 #include "Animator.h"
 #include "Renderer.h"
 #include "SaveManager.h"
 #include "RankList.h"
+#include "PlayerStats.h"
+#include "Replay.h"
+#include "ReplayPlayer.h"
+#include "MoveHistory.h"
+#include "MonteCarloAI.h"
+#include "NTupleNetwork.h"
+#include "EvilSpawner.h"
+#include "HintSearch.h"
+#include "JobSystem.h"
+#include "OpeningBook.h"
+#include "Policy.h"
 #include "Menu.h"
+#include "FrameSnapshot.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
 
 enum class GameState {
     MENU,//菜单状态
     PLAYING,
     WON,//胜利状态
     GAME_OVER,//游戏结束状态
-    RANK_LIST  // 排行榜显示状态
+    RANK_LIST,  // 排行榜显示状态
+    REPLAY      // 回放观看状态
+};
+
+// 自动走子策略
+enum class AutoplayPolicy {
+    MONTE_CARLO_RANDOM,  // 蒙特卡洛，随机模拟
+    MONTE_CARLO_GREEDY,  // 蒙特卡洛，贪心模拟
+    NTUPLE,              // n元组网络一步贪心（需要 ntuple.bin）
+    SEARCH,              // 两层期望最大化搜索
+    GREEDY,              // 即时得分贪心
+    CORNER               // 角落策略
 };
 
 class Game {
@@ -23,57 +50,141 @@ public:
     Game();
     ~Game();
     
-    // 主运行循环
+    // 主运行循环：本线程处理窗口事件并绘制，游戏逻辑在单独的线程中运行
     void run();
     
 private:
-    sf::RenderWindow window_;//窗口
-    sf::Clock clock_;//时钟
+    sf::RenderWindow window_;//窗口（只在主线程使用）
+    sf::Clock clock_;//时钟（逻辑线程）
+    sf::Clock rankWatchClock_;//排行榜文件变更检查计时
     
     Board board_;//游戏逻辑计算
     Animator animator_;//动画
     Renderer renderer_;//渲染
     SaveManager saveManager_;//存档管理
     RankList rankList_;//排行榜
+    PlayerStats playerStats_;//玩家统计（局数、平均分、最大方块、步数）
+    JobSystem jobs_;//共享任务系统（提示、困难模式、蒙特卡洛和读写都在这里执行，在使用它的成员之前构造）
+    JobStrand io_;//存档、排行榜、玩家统计和回放的读写（低优先级，按提交顺序执行）
     Menu menu_;  // 新增：菜单管理器
+    bool nameIndexBuilding_;//名字前缀索引是否正在后台构建（同一时刻只建一个）
+    uint64_t nameIndexFailedVersion_;//上次构建失败的排行榜版本（不再重试同一版本）
     
     GameState state_;//游戏状态
     std::string username_;//用户名
     bool wonDisplayed_;//是否显示胜利
+    std::string gameOverSummary_;//游戏结束时的分数分布说明
+    int moveCount_;//本局有效移动步数
+    Replay replay_;//本局回放（起始局面 + 每步方向）
+    ReplayPlayer replayPlayer_;//回放播放器（关键帧跳转）
+    MoveHistory history_;//撤销/重做历史
+    size_t replaySpeedIndex_;//回放倍速档位
+    bool replayPaused_;//回放是否暂停
+    float replayAccumulator_;//回放累计的待播放步数
+    MonteCarloAI ai_;//蒙特卡洛走子（后台任务）
+    NTupleNetwork evaluator_;//n元组网络估值（只读映射 ntuple.bin）
+    bool autoplay_;//是否自动走子
+    AutoplayPolicy autoplayPolicy_;//自动走子策略
+    AnyPolicy autoplayStrategy_;//同步策略（蒙特卡洛以外的策略，每步当场计算）
+    EvilSpawner evilSpawner_;//困难模式生成器（后台任务中的极小极大搜索）
+    bool hardMode_;//困难模式：新方块放在对玩家最不利的位置
+    bool hardModeUsed_;//本局是否出现过困难模式的方块（回放无法重现，不再写回放）
+    OpeningBook openingBook_;//开局库（opening.bin，第一次查询时才映射）
+    HintSearch hintSearch_;//走子提示（后台迭代加深，结果写入原子槽位）
+    bool hintEnabled_;//是否显示提示
+    bool hintRequested_;//当前局面是否已提交提示搜索
+    uint64_t hintBoard_;//已提交的局面（紧凑表示）
+    uint32_t hintGeneration_;//已提交的请求编号
+    bool showJobStats_;//是否在状态栏显示任务系统统计（F3）
     
     int menuSelection_;  // 菜单选项索引（保留兼容性）
     
-    // 状态机处理
+    // 线程划分：主线程只处理窗口事件和绘制；逻辑线程负责输入、动画、游戏规则、存档和排行榜
+    // 输入经单生产者单消费者队列传给逻辑线程，绘制数据经三缓冲整份传回，双方都不等待对方
+    std::thread logicThread_;//逻辑线程
+    std::atomic<bool> stopping_;//窗口已关闭，逻辑线程退出
+    std::atomic<bool> quitRequested_;//逻辑线程请求关闭窗口（菜单中的退出）
+    SpscQueue<sf::Event, 256> input_;//窗口事件（主线程 → 逻辑线程）
+    TripleBuffer<FrameSnapshot> frames_;//绘制快照（逻辑线程 → 主线程）
+    
+    // 逻辑线程：按显示帧率的固定节拍运行，每拍处理输入、推进游戏并发布一帧快照
+    void logicLoop();
+    void updateLogic();
+    void handleEvent(const sf::Event& event);
+    
+    // 把棋盘界面写入待发布的快照
+    void fillBoardFrame(const Board& board, const std::string& username, int bestScore,
+                        const std::string& statusText, const std::string& detailText = "",
+                        const Hint* hint = nullptr);
+    
+    // 状态机处理（生成本帧的快照）
     void handleMenuState();
     void handlePlayingState();
     void handleWonState();
     void handleGameOverState();
     void handleRankListState();  // 排行榜状态
+    void handleReplayState(float deltaTime);  // 回放状态
     
-    // 输入处理
-    void processInput();
+    // 按键处理
+    void processInput(sf::Keyboard::Key key);
     
     // 移动处理
     void handleMove(Direction dir);
     
+    // 撤销/重做（带倒放/正放动画）
+    void undoMove();
+    void redoMove();
+    
     // 生成MoveEvent列表（需要知道方向以避免斜向移动）
     std::vector<MoveEvent> computeMoveEvents(const int gridBefore[4][4], 
                                             const int gridAfter[4][4],
                                             Direction dir);
     
+    // 生成新方块：困难模式取生成器的搜索结果，否则随机
+    std::pair<std::pair<int, int>, int> spawnTile();
+    
     // 动画完成回调
-    void onMoveAnimationComplete(const MoveResult& result);
+    void onMoveAnimationComplete(const MoveResult& result, Direction dir);
     void onSpawnAnimationComplete();
     
     // 游戏状态检查
     void checkGameState();
     
+    // 存档读写：写入交给 io_ 在后台执行；读取前等待已提交的写入完成
+    void saveAsync();
+    bool hasSave();
+    
+    // 任务系统统计（队列长度、排队等待时间）的状态栏文字
+    std::string jobStatsText() const;
+    
     // 初始化新游戏
     void startNewGame();
     
     // 继续存档游戏
     void continueGame();
     
+    // 加载的回放是否属于当前玩家，且重放后正好得到存档的局面
+    bool replayMatchesBoard() const;
+    
+    // 游戏结束时把回放写入 replays/ 目录
+    void writeReplay(int score);
+    
+    // 回放观看：开始播放、带动画前进一步、跳转、切换倍速
+    void startReplay(const Replay& replay);
+    void stepReplayAnimated();
+    void seekReplay(size_t move);
+    void setReplaySpeed(size_t speedIndex);
+    
+    // 自动走子：每帧检查后台决策结果，动画结束后执行
+    void updateAutoplay();
+    void setAutoplay(bool enabled);
+    void cycleAutoplayPolicy();
+    std::string autoplayStatus() const;
+    
+    // 走子提示：局面静止且变化后提交搜索；玩家一移动就取消
+    void updateHint();
+    void cancelHint();
+    
     // 获取用户名输入（简化版，使用预设名称）
     void getUsernameInput();
 };
@@ -0,0 +1,80 @@
+#ifndef HINTSEARCH_H
+#define HINTSEARCH_H
+
+#include "Board.h"
+#include "JobSystem.h"
+#include "NTupleNetwork.h"
+#include "OpeningBook.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// 一条提示：建议方向、置信度（0~100）和得出它的搜索深度
+struct Hint {
+    Direction dir;
+    int confidence;
+    int depth;
+};
+
+// 置换表项：以8种对称中的最小表示为键；同一局面的估值与请求无关，跨请求保留
+struct HintEntry {
+    uint64_t key;
+    float value;
+    int depth;
+};
+
+// 走子提示：随时可取的期望最大化（expectimax）搜索
+// 提交局面时当场算出一步贪心的提示（零延迟），后台任务（共享任务系统的高优先级串行队列）从第2层开始迭代加深，
+// 每完成一层就把结果写入一个原子槽位；界面每帧无锁读取槽位，提示质量随时间收敛
+// 玩家一移动就取消：请求编号加一，后台搜索在下一次检查时放弃，槽位里的旧结果也不再匹配
+class HintSearch {
+public:
+    static constexpr int MAX_DEPTH = 6;         // 玩家走子层数
+    static constexpr int MAX_SEARCH_MS = 2000;  // 玩家长时间不动时不再加深，避免空耗CPU
+    
+    explicit HintSearch(JobSystem& jobs);
+    ~HintSearch();
+    
+    HintSearch(const HintSearch&) = delete;
+    HintSearch& operator=(const HintSearch&) = delete;
+    
+    // 叶子估值用的网络（不拥有）；为空时用空格数和可合并对数的启发式
+    // 置换表在后台下一次搜索开始时清空
+    void setEvaluator(const NTupleNetwork* network);
+    
+    // 开局库（不拥有）：提交的局面在库里时直接发布库里的结果，不再搜索
+    void setBook(const OpeningBook* book);
+    
+    // 提交局面（紧凑表示）：立即发布一步贪心的提示，后台开始加深；返回本次请求的编号
+    uint32_t request(uint64_t packed);
+    
+    // 作废当前请求（玩家移动、撤销、关闭提示时调用）
+    void cancel();
+    
+    // 读取编号对应的最新提示（无锁）；还没有结果或已被取消返回false
+    bool current(uint32_t generation, Hint& hint) const;
+    
+    // 同步搜索到指定深度（工具和测试用，使用独立的置换表，不查开局库）；无合法方向返回false
+    // value 返回最佳方向的期望得分
+    static bool search(uint64_t packed, int depth, const NTupleNetwork* network, Hint& hint,
+                       float* value = nullptr);
+
+private:
+    const NTupleNetwork* network_;
+    const OpeningBook* book_;
+    std::vector<HintEntry> table_;            // 只由后台任务使用（串行队列保证同一时刻只有一个）
+    bool clearTable_;
+    std::mutex mutex_;                        // 保护 network_、book_、clearTable_
+    
+    std::atomic<uint32_t> generation_;        // 最新请求的编号，取消时也加一
+    std::atomic<uint64_t> slot_;              // 编号(32) | 深度(8) | 置信度(8) | 方向(8)
+    
+    JobStrand strand_;                        // 最后一个成员：析构时最先等待未完成的任务
+    
+    void publish(uint32_t generation, const Hint& hint);
+    void deepen(uint64_t board, uint32_t generation);
+};
+
+#endif // HINTSEARCH_H
@@ -0,0 +1,292 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 任务优先级：空闲的工作线程总是先取高优先级的任务（自己的队列和别人的队列都先看高优先级）
+// 已经开始执行的任务不会被打断，长任务应自行检查取消标记、尽早返回
+enum class JobPriority {
+    HIGH = 0,    // 界面在等结果：走子提示、困难模式的生成器
+    NORMAL = 1,  // 计算：蒙特卡洛走子
+    LOW = 2      // 批量读写：存档、排行榜、回放、玩家统计
+};
+
+// 无返回值任务的结果
+struct JobDone {};
+
+// 任务系统的统计（界面显示用），时间为指数滑动平均（新样本占1/8）
+struct JobStats {
+    int workers;
+    size_t queued[3];        // 各优先级排队中的任务数
+    uint64_t completed[3];   // 各优先级已完成的任务数
+    double waitMs[3];        // 各优先级从提交到开始执行的时间
+    double runMs[3];         // 各优先级的执行时间
+    uint64_t steals;         // 从其他线程的队列偷来的任务数
+};
+
+class JobSystem;
+
+// 任务结果：任务完成后可以在任意线程 wait/get，
+// 也可以用 then 登记回调，回调在调用 JobSystem::runCompletions 的线程（游戏逻辑线程）执行
+template <typename T>
+class JobFuture {
+public:
+    JobFuture() = default;
+    
+    bool valid() const { return state_ != nullptr; }
+    
+    // 是否已完成（无锁）
+    bool isReady() const { return state_ && state_->ready.load(std::memory_order_acquire); }
+    
+    // 等待完成（任务抛出的异常在 get 时重新抛出）
+    void wait() const;
+    const T& get() const;
+    
+    // 完成后把结果交给 callback（在 runCompletions 中调用）；已完成时在下一次 runCompletions 调用
+    // 任务抛出异常时改为调用 onError（同样在 runCompletions 中），异常本身已由任务系统记录到日志
+    template <typename Callback>
+    void then(Callback callback, std::function<void(std::exception_ptr)> onError = nullptr);
+
+private:
+    friend class JobSystem;
+    friend class JobStrand;
+    
+    struct State {
+        explicit State(JobSystem& owner) : system(owner), ready(false) {}
+        
+        JobSystem& system;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::atomic<bool> ready;
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::function<void(const T&)> continuation;
+        std::function<void(std::exception_ptr)> errorContinuation;
+        
+        void finish();
+    };
+    
+    explicit JobFuture(std::shared_ptr<State> state) : state_(std::move(state)) {}
+    
+    std::shared_ptr<State> state_;
+};
+
+// 任务函数 F 的结果类型（无返回值时为 JobDone）
+template <typename F>
+using JobResultOf = typename std::conditional<std::is_void<std::invoke_result_t<F&>>::value, JobDone,
+                                              std::invoke_result_t<F&>>::type;
+
+// 共享的任务系统：固定数量的工作线程，每个线程有自己的各优先级队列
+// 外部线程提交的任务轮流放入各线程的队列；工作线程执行中提交的任务放入自己的队列
+// 线程从自己队列的尾部取（刚提交的数据还在缓存里），自己没有时从别的线程队列的头部偷
+// 析构时执行完所有已提交的任务再退出
+class JobSystem {
+public:
+    static const int PRIORITY_COUNT = 3;
+    
+    // workers 为0时取 CPU核数-1（至少2个，长任务执行时短任务仍有线程可用）
+    explicit JobSystem(int workers = 0);
+    ~JobSystem();
+    
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    
+    // 提交任务，返回其结果
+    template <typename F>
+    JobFuture<JobResultOf<F>> submit(JobPriority priority, F fn);
+    
+    // 执行已就绪的 then 回调（游戏逻辑线程每帧调用），返回执行的个数
+    size_t runCompletions();
+    
+    JobStats stats() const;
+    int workerCount() const { return static_cast<int>(threads_.size()); }
+
+private:
+    template <typename T>
+    friend class JobFuture;
+    friend class JobStrand;
+    
+    using Clock = std::chrono::steady_clock;
+    
+    struct Job {
+        std::function<void()> run;
+        Clock::time_point queuedAt;
+    };
+    
+    // 每个工作线程的队列，独占缓存行，减少线程间争用
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Job> queues[PRIORITY_COUNT];
+    };
+    
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<uint32_t> nextWorker_;            // 外部提交时轮流选择的队列
+    std::atomic<size_t> pending_;                 // 所有队列中的任务总数
+    
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+    
+    std::mutex completionMutex_;
+    std::vector<std::function<void()>> completions_;   // 等待逻辑线程执行的 then 回调
+    
+    std::atomic<size_t> queued_[PRIORITY_COUNT];
+    std::atomic<uint64_t> completed_[PRIORITY_COUNT];
+    std::atomic<uint64_t> waitMicros_[PRIORITY_COUNT];
+    std::atomic<uint64_t> runMicros_[PRIORITY_COUNT];
+    std::atomic<uint64_t> steals_;
+    
+    void push(JobPriority priority, std::function<void()> run);
+    bool pop(int self, Job& job, int& priority);
+    void workerLoop(int index);
+    void postCompletion(std::function<void()> callback);
+    
+    // 把任务抛出的异常写入日志
+    static void logFailure(const std::exception_ptr& error);
+    
+    // 把任务函数包装成：执行、保存结果或异常、通知等待者和回调
+    template <typename T, typename F>
+    static std::function<void()> wrap(std::shared_ptr<typename JobFuture<T>::State> state, F fn);
+};
+
+// 串行队列：提交到同一个 strand 的任务按提交顺序逐个执行，运行在共享线程池中，不占专用线程
+// 同一组件的任务（同一份置换表、同一个文件）放在一个 strand 里，彼此不必再加锁
+// 析构时等待已提交的任务全部完成
+class JobStrand {
+public:
+    JobStrand(JobSystem& system, JobPriority priority);
+    ~JobStrand();
+    
+    JobStrand(const JobStrand&) = delete;
+    JobStrand& operator=(const JobStrand&) = delete;
+    
+    template <typename F>
+    JobFuture<JobResultOf<F>> submit(F fn);
+    
+    // 等待已提交的任务全部完成（读文件前调用，保证读到之前提交的写入）
+    void flush();
+    
+    // 排队中（未开始）的任务数
+    size_t queued() const;
+
+private:
+    JobSystem& system_;
+    JobPriority priority_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::deque<std::function<void()>> jobs_;
+    bool running_;            // 线程池中是否已有一个任务在依次执行本队列
+    
+    void post(std::function<void()> run);
+    void drain();
+};
+
+template <typename T>
+void JobFuture<T>::State::finish() {
+    std::function<void(const T&)> callback;
+    std::function<void(std::exception_ptr)> onError;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.store(true, std::memory_order_release);
+        if (!error) {
+            callback = std::move(continuation);
+        } else {
+            onError = std::move(errorContinuation);
+        }
+        continuation = nullptr;
+        errorContinuation = nullptr;
+    }
+    done.notify_all();
+    if (callback) {
+        // then 登记的回调捕获了状态的 shared_ptr，结果在回调执行前不会释放
+        system.postCompletion([this, callback]() { callback(*value); });
+    }
+    if (onError) {
+        std::exception_ptr failure = error;
+        system.postCompletion([onError, failure]() { onError(failure); });
+    }
+}
+
+template <typename T>
+void JobFuture<T>::wait() const {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->done.wait(lock, [this]() { return state_->ready.load(std::memory_order_relaxed); });
+}
+
+template <typename T>
+const T& JobFuture<T>::get() const {
+    wait();
+    if (state_->error) {
+        std::rethrow_exception(state_->error);
+    }
+    return *state_->value;
+}
+
+template <typename T>
+template <typename Callback>
+void JobFuture<T>::then(Callback callback, std::function<void(std::exception_ptr)> onError) {
+    std::shared_ptr<State> state = state_;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (!state->ready.load(std::memory_order_relaxed)) {
+        // 回调捕获状态，保证结果在回调执行前有效
+        state->continuation = [state, callback](const T& value) mutable { callback(value); };
+        state->errorContinuation = std::move(onError);
+        return;
+    }
+    lock.unlock();
+    if (!state->error) {
+        state->system.postCompletion([state, callback]() mutable { callback(*state->value); });
+    } else if (onError) {
+        state->system.postCompletion([state, onError]() { onError(state->error); });
+    }
+}
+
+template <typename T, typename F>
+std::function<void()> JobSystem::wrap(std::shared_ptr<typename JobFuture<T>::State> state, F fn) {
+    return [state, fn]() mutable {
+        try {
+            if constexpr (std::is_void<std::invoke_result_t<F&>>::value) {
+                fn();
+                state->value.emplace();
+            } else {
+                state->value.emplace(fn());
+            }
+        } catch (...) {
+            state->error = std::current_exception();
+            logFailure(state->error);
+        }
+        state->finish();
+    };
+}
+
+template <typename F>
+JobFuture<JobResultOf<F>> JobSystem::submit(JobPriority priority, F fn) {
+    using Result = JobResultOf<F>;
+    auto state = std::make_shared<typename JobFuture<Result>::State>(*this);
+    push(priority, wrap<Result>(state, std::move(fn)));
+    return JobFuture<Result>(state);
+}
+
+template <typename F>
+JobFuture<JobResultOf<F>> JobStrand::submit(F fn) {
+    using Result = JobResultOf<F>;
+    auto state = std::make_shared<typename JobFuture<Result>::State>(system_);
+    post(JobSystem::wrap<Result>(state, std::move(fn)));
+    return JobFuture<Result>(state);
+}
+
+#endif // JOBSYSTEM_H
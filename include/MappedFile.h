@@ -0,0 +1,31 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+// 只读内存映射文件（RAII，析构时自动解除映射）
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    // 映射整个文件，失败或文件为空时返回false
+    bool open(const std::string& path);
+    
+    // 解除映射
+    void close();
+    
+    bool isOpen() const { return data_ != nullptr; }
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+    
+private:
+    void* data_;
+    size_t size_;
+};
+
+#endif // MAPPEDFILE_H
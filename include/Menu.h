@@ -2,7 +2,10 @@
 #define MENU_H
 
 #include <string>
+#include <memory>
+#include <vector>
 #include <SFML/Graphics.hpp>
+#include "PrefixIndex.h"
 
 
 struct Button {//按钮结构
@@ -30,12 +33,40 @@ enum class MenuAction {//菜单操作枚举
 };
 
 
+// 菜单和排行榜界面的绘制数据：逻辑线程每帧从 Menu 复制一份，渲染线程只读这份副本
+struct MenuView {
+    struct ButtonView {
+        Button button;
+        bool hovered;
+    };
+    
+    struct SuggestionView {
+        std::string username;
+        int score;
+        float x, y, width, height;//在界面上的位置
+        bool selected;
+    };
+    
+    std::string playerName;                   // 输入框中显示的名字
+    bool inputActive = false;                 // 输入框是否激活
+    bool inputBoxHovered = false;             // 输入框是否悬停
+    float inputBoxX = 0, inputBoxY = 0, inputBoxWidth = 0, inputBoxHeight = 0;
+    std::vector<ButtonView> buttons;          // 菜单界面的按钮（已按是否有存档筛选）
+    ButtonView backButton = {};               // 排行榜界面的返回按钮
+    std::vector<SuggestionView> suggestions;  // 名字补全建议
+    size_t rankScrollOffset = 0;              // 排行榜滚动偏移
+    RankPeriod rankPeriod = RankPeriod::ALL_TIME;
+};
+
+
 class Menu {
 private:
     std::string playerName;     // 玩家名称
     bool hasSaveFile;           // 是否有存档
     bool inputActive;           // 输入框是否激活
     int hoveredButton;          // 当前悬停的按钮索引
+    size_t rankScrollOffset;    // 排行榜滚动偏移（首个可见行的下标）
+    RankPeriod rankPeriod;      // 排行榜当前显示的时段
     
     // 按钮定义
     Button continueButton;//继续游戏按钮
@@ -51,9 +82,18 @@ private:
     float inputBoxWidth;//输入框宽度
     float inputBoxHeight;//输入框高度
     
+    // 名字自动补全
+    std::shared_ptr<const PrefixIndex> nameIndex;  // 排行榜用户名前缀索引（后台构建后换入，可能为空）
+    std::vector<RankEntryView> suggestions;  // 当前补全建议（按分数降序）
+    int selectedSuggestion;                  // 选中的建议下标，-1 表示未选中
+    
     void initButtons();//初始化按钮
+    void updateSuggestions();//根据当前输入刷新补全建议
 
 public:
+    static const size_t RANK_VISIBLE_ROWS = 10;  // 排行榜一屏显示的行数
+    static const size_t MAX_SUGGESTIONS = 4;     // 输入框下方最多显示的补全建议数
+    
     Menu();
     
     void setHasSaveFile(bool hasSave);//设置是否有存档
@@ -79,8 +119,25 @@ public:
     const Button& getQuitButton() const;//获取退出按钮
     const Button& getBackButton() const;//获取返回按钮
     
+    uint64_t getNameIndexVersion() const;//当前前缀索引对应的排行榜版本，0 表示还没有索引
+    void setNameIndex(std::shared_ptr<const PrefixIndex> index);//换入后台建好的前缀索引并刷新补全建议
+    const std::vector<RankEntryView>& getSuggestions() const;//获取补全建议（仅输入框激活时非空）
+    int getSelectedSuggestion() const;//获取选中的建议下标
+    void moveSuggestionSelection(int delta);//上下移动建议选择
+    bool acceptSuggestion();//用选中的建议（未选中时取第一个）替换输入
+    bool handleSuggestionClick(int mouseX, int mouseY);//处理建议列表点击
+    void getSuggestionBox(size_t index, float& x, float& y, float& width, float& height) const;//获取建议行位置
+    
+    void scrollRankList(int deltaRows, size_t totalRows);//滚动排行榜（正数向下）
+    void resetRankScroll();//重置排行榜滚动位置
+    size_t getRankScrollOffset() const;//获取排行榜滚动偏移
+    void cycleRankPeriod(int delta);//切换排行榜时段（总榜/本周/今日）
+    RankPeriod getRankPeriod() const;//获取排行榜当前时段
+    
     void getInputBox(float& x, float& y, float& width, float& height) const;//获取输入框
     bool hasLoadGame() const;//检查是否有存档
+    
+    void fillView(MenuView& view) const;//复制绘制数据（复用 view 中已有的容量）
 };
 
 #endif // MENU_H
@@ -0,0 +1,80 @@
+#ifndef MONTECARLOAI_H
+#define MONTECARLOAI_H
+
+#include "Board.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// 模拟方式：随机走子，或每步取即时得分最大的方向
+enum class PlayoutPolicy {
+    RANDOM,
+    GREEDY
+};
+
+// 一次决策的统计
+struct MonteCarloStats {
+    uint64_t playouts;       // 总模拟局数
+    uint64_t moves;          // 模拟中走的总步数
+    double milliseconds;     // 实际耗时
+    double meanScore[4];     // 各方向的平均得分（无效方向为负）
+};
+
+// 蒙特卡洛走子：对每个合法方向做大量模拟对局，选平均得分最高的方向
+// 模拟按批进行：BATCH_SIZE 个局面存在连续数组中同步推进一步，批内全部结束后换下一个方向，
+// 轮流进行直到时间预算用完。决策作为共享任务系统的普通优先级任务完成，界面线程只提交局面和取结果
+class MonteCarloAI {
+public:
+    static const int BATCH_SIZE = 64;
+    static const int DEFAULT_BUDGET_MS = 100;
+    
+    explicit MonteCarloAI(JobSystem& jobs);
+    ~MonteCarloAI();
+    
+    MonteCarloAI(const MonteCarloAI&) = delete;
+    MonteCarloAI& operator=(const MonteCarloAI&) = delete;
+    
+    void setTimeBudget(int milliseconds);
+    int getTimeBudget() const { return budgetMs_.load(); }
+    void setPlayoutPolicy(PlayoutPolicy policy);
+    PlayoutPolicy getPlayoutPolicy() const { return policy_.load(); }
+    
+    // 同步决策（调用线程上计算，工具和后台线程共用）；无合法方向返回false
+    bool chooseMove(uint64_t packed, Direction& dir, MonteCarloStats* stats = nullptr);
+    
+    // 异步决策：提交局面后立即返回，之前未完成的请求被取代
+    void request(uint64_t packed);
+    // 取结果：只有针对该局面的决策完成时返回true（局面已变化的旧结果会被丢弃）
+    bool poll(uint64_t packed, Direction& dir);
+    bool isBusy() const;
+    void cancel();
+    
+    // 最近一次完成的决策统计（界面显示用）
+    MonteCarloStats lastStats() const;
+
+private:
+    std::atomic<int> budgetMs_;
+    std::atomic<PlayoutPolicy> policy_;
+    uint64_t rngState_;
+    
+    // 请求/结果槽（后台任务在串行队列中逐个执行，rngState_ 同一时刻只有一个任务使用）
+    mutable std::mutex mutex_;
+    uint32_t requestGeneration_;   // 最新请求的编号，被取代或取消时加一
+    bool hasRequest_;              // 已提交、还没开始
+    bool busy_;
+    bool hasResult_;
+    uint64_t resultBoard_;
+    Direction resultDir_;
+    MonteCarloStats lastStats_;
+    std::atomic<bool> cancelled_;
+    
+    JobStrand strand_;             // 最后一个成员：析构时最先等待未完成的任务
+    
+    void runDecision(uint64_t board, uint32_t generation);
+    
+    // 从同一个后状态出发的一批模拟，返回这批的总得分
+    uint64_t runBatch(uint64_t afterstate, PlayoutPolicy policy, uint64_t& moves);
+};
+
+#endif // MONTECARLOAI_H
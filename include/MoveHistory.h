@@ -0,0 +1,54 @@
+#ifndef MOVEHISTORY_H
+#define MOVEHISTORY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Board.h"
+
+// 撤销/重做历史：固定容量的环形缓冲区，每条16字节
+//   网格 u64（4位 log2 x 16格）| 分数 u32 | 随机数生成次数（低30位）+ 造成该局面的方向（高2位）
+// 随机数状态不直接存储：Board 的随机数每次生成前进固定步长，由起点和生成次数即可还原
+// 容量用完时覆盖最旧的记录；撤销后执行新移动会丢弃可重做的部分
+class MoveHistory {
+public:
+    static const size_t DEFAULT_CAPACITY = 1024;  // 1024步 x 16字节 = 16KB
+    
+    explicit MoveHistory(size_t capacity = DEFAULT_CAPACITY);
+    
+    // 以当前局面为起点清空历史（新游戏/继续存档时调用）
+    void reset(const Board& board);
+    
+    // 记录一步移动之后的局面（在提交移动并生成新方块之后调用）
+    void push(const Board& board, Direction dir);
+    
+    bool canUndo() const { return cursor_ > 0; }
+    bool canRedo() const { return cursor_ + 1 < count_; }
+    
+    // 撤销：把 board 还原为上一步之前的局面，dir 为被撤销的那一步的方向
+    bool undo(Board& board, Direction& dir);
+    
+    // 重做：把 board 前进到下一步之后的局面，dir 为重做的那一步的方向
+    bool redo(Board& board, Direction& dir);
+    
+    size_t size() const { return count_; }
+    size_t capacity() const { return entries_.size(); }
+    
+private:
+    struct Entry {
+        uint64_t grid;
+        uint32_t score;
+        uint32_t drawsAndDir;
+    };
+    
+    std::vector<Entry> entries_;
+    size_t oldest_;       // 最旧记录在环中的下标
+    size_t count_;        // 有效记录数（含当前局面）
+    size_t cursor_;       // 当前局面相对最旧记录的偏移
+    uint64_t rngBase_;    // 生成次数的起点
+    
+    Entry& at(size_t offset) { return entries_[(oldest_ + offset) % entries_.size()]; }
+    void restore(const Entry& entry, Board& board) const;
+};
+
+#endif // MOVEHISTORY_H
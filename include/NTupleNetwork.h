@@ -0,0 +1,72 @@
+#ifndef NTUPLENETWORK_H
+#define NTUPLENETWORK_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// n元组网络估值函数：若干个元组（每个覆盖固定的几个格子），每个在8种对称下查表求和
+// 权重文件为扁平float数组，可以直接内存映射（只读，多个进程共享同一份物理页）
+//
+// 文件格式（小端）：
+//   头部128字节: "2048NTW1" | 元组数 u32 | 元组长度 u32 | 保留 u64 | 各元组格子下标 8x8 u8 | 填充
+//   权重: 元组数 x 16^元组长度 个 float，第 t 个元组的表从 t * 16^元组长度 开始
+class NTupleNetwork {
+public:
+    static const int MAX_TUPLES = 8;
+    static const int MAX_TUPLE_SIZE = 6;
+    static const size_t HEADER_SIZE = 128;
+    
+    NTupleNetwork();
+    
+    NTupleNetwork(const NTupleNetwork&) = delete;
+    NTupleNetwork& operator=(const NTupleNetwork&) = delete;
+    
+    // 默认结构：4个6元组（两种直线、两种2x3矩形），权重共256MB
+    static std::vector<std::vector<int>> defaultTuples();
+    // 小结构：4个4元组（两种直线、两种方块），权重共1MB，训练快但上限低
+    static std::vector<std::vector<int>> smallTuples();
+    
+    // 新建全零权重（可写），元组长度必须一致
+    bool create(const std::vector<std::vector<int>>& tuples);
+    
+    // 只读映射权重文件（AI估值用，零拷贝）
+    bool open(const std::string& path);
+    // 读入可写内存（继续训练用）
+    bool load(const std::string& path);
+    // 写入临时文件再改名，读者不会看到写了一半的文件
+    bool saveTo(const std::string& path) const;
+    
+    bool isReady() const { return weights_ != nullptr; }
+    bool isWritable() const { return !owned_.empty(); }
+    int tupleCount() const { return static_cast<int>(tuples_.size()); }
+    int featureCount() const { return tupleCount() * 8; }
+    size_t weightCount() const { return tuples_.size() * tableSize_; }
+    
+    // 局面估值（紧凑表示）
+    float evaluate(uint64_t packed) const;
+    
+    // 局面涉及的每个权重加上 delta（多线程训练时不加锁，Hogwild 式更新，偶尔丢失更新可以容忍）
+    void update(uint64_t packed, float delta);
+    
+    // 一步贪心：选择 即时得分 + 后状态估值 最大的方向；无合法方向返回false
+    bool bestMove(uint64_t packed, Direction& dir, float* value = nullptr) const;
+
+private:
+    std::vector<std::vector<int>> tuples_;
+    std::vector<uint8_t> cells_;    // [元组][对称][格子]，8种对称展开后的格子下标
+    int tupleSize_;
+    size_t tableSize_;              // 16^元组长度
+    
+    std::vector<float> owned_;      // 可写权重（create/load）
+    MappedFile mapped_;             // 只读映射（open）
+    const float* weights_;
+    
+    bool setTuples(const std::vector<std::vector<int>>& tuples);
+    bool readHeader(const char* data, size_t size);
+    size_t indexOf(uint64_t packed, const uint8_t* cells) const;
+};
+
+#endif // NTUPLENETWORK_H
@@ -0,0 +1,89 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 开局库记录的排列方式
+enum class BookLayout : uint32_t {
+    SORTED = 0,     // 按键升序，二分查找
+    EYTZINGER = 1   // 按完全二叉树的层序排列（下标从1开始），查找路径上的记录集中在前几个缓存行
+};
+
+// 开局库文件中的一条记录（16字节）：键是8种对称中的最小表示，方向按该表示给出
+struct BookRecord {
+    uint64_t key;
+    float value;          // 最佳方向的期望得分（即时得分 + 后续期望）
+    uint8_t dir;
+    uint8_t confidence;   // 0~100，与走子提示的置信度含义相同
+    uint8_t depth;        // 预计算时的搜索深度
+    uint8_t reserved;
+};
+
+// 查询结果（方向已换回查询局面的朝向）
+struct BookMove {
+    Direction dir;
+    float value;
+    int confidence;
+    int depth;
+};
+
+// 开局库：前K步可能出现的所有局面（按对称合并）的最佳方向和期望得分，由 tools/opening_book 预先算好
+// 文件只读映射，open 只记下路径，第一次查询时才映射，启动时不读文件
+// 文件格式: "2048OPB1" | 记录数 u32 | 排列方式 u32 | 步数K u32 | 搜索深度 u32 | 保留 | 记录...（头部32字节）
+class OpeningBook {
+public:
+    static const size_t HEADER_SIZE = 32;
+    
+    OpeningBook();
+    
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+    
+    // 记下文件路径（不访问文件）；第一次 lookup 时映射，文件不存在则之后的查询都返回false
+    void open(const std::string& path);
+    
+    // 查询局面（紧凑表示）；不在库里返回false。可以多线程同时调用
+    bool lookup(uint64_t packed, BookMove& move) const;
+    
+    // 以下会触发映射
+    bool isAvailable() const;
+    size_t size() const;
+    BookLayout layout() const;
+    int plies() const;
+    int depth() const;
+    
+    // 写入开局库（记录会被重排）；写临时文件再改名
+    static bool write(const std::string& path, std::vector<BookRecord> records, BookLayout layout,
+                      int plies, int depth);
+    
+    // 8种对称中的最小表示，同时给出变换编号（与 Board::canonical 的结果相同）
+    // 编号: bit0 左右镜像, bit1 上下翻转, bit2 最后转置
+    static uint64_t canonicalize(uint64_t packed, int& symmetry);
+    // 方向在原局面与最小表示之间换算
+    static Direction toCanonical(Direction dir, int symmetry);
+    static Direction fromCanonical(Direction dir, int symmetry);
+
+private:
+    std::string path_;
+    
+    mutable std::mutex mutex_;
+    mutable std::atomic<bool> attempted_;   // 是否已尝试映射（成功与否都不再重试）
+    mutable MappedFile mapped_;
+    mutable const BookRecord* records_;
+    mutable size_t count_;
+    mutable BookLayout layout_;
+    mutable int plies_;
+    mutable int depth_;
+    
+    void ensureMapped() const;
+    const BookRecord* findSorted(uint64_t key) const;
+    const BookRecord* findEytzinger(uint64_t key) const;
+};
+
+#endif // OPENINGBOOK_H
@@ -0,0 +1,76 @@
+#ifndef PERIODRANKS_H
+#define PERIODRANKS_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <cstdint>
+
+// 排行榜统计时段
+enum class RankPeriod {
+    ALL_TIME,  // 总榜
+    WEEKLY,    // 本周（周一开始，本地时间）
+    DAILY      // 今日（本地时间）
+};
+
+// 时段汇总：过期的日榜/周榜压缩成一条记录，只保留最近若干条
+struct PeriodRollup {
+    char kind;             // 'D' 日榜，'W' 周榜
+    long periodId;         // 日编号或周编号
+    uint32_t players;      // 该时段上榜人数
+    int topScore;          // 该时段最高分
+    std::string topName;   // 最高分玩家
+};
+
+// 日榜/周榜：每个玩家在当前时段内的最高分
+// 按 (分数降序, 时间升序, 用户名) 有序存放，取前N名为 O(log n + N)；
+// 时段结束时整榜压缩为一条 PeriodRollup，文件大小与运行时长无关
+class PeriodRanks {
+public:
+    PeriodRanks();
+    
+    // 记录一局得分（先按timestamp推进时段）
+    void record(const std::string& username, int score, int64_t timestamp);
+    
+    // 推进到now所在的时段：过期的榜单压缩为汇总，返回是否发生了压缩
+    bool advance(int64_t now);
+    
+    // 取指定时段的前n名（ALL_TIME 不由本类维护，返回空）
+    std::vector<std::pair<std::string, int>> top(RankPeriod period, size_t n) const;
+    
+    // 最近的时段汇总（日榜在前，新的在前）
+    const std::vector<PeriodRollup>& rollups() const { return rollups_; }
+    
+    // 从文件合并（分数取最大值、汇总按时段去重），文件不存在返回false
+    bool mergeFrom(const std::string& path);
+    
+    // 写入文件（临时文件 + rename）
+    bool saveTo(const std::string& path) const;
+    
+    // 本地日编号/周编号
+    static long dayOf(int64_t timestamp);
+    static long weekOf(int64_t timestamp);
+    
+private:
+    struct Board {
+        char kind;
+        long periodId;
+        std::map<std::string, std::pair<int, int64_t>> byName;     // 用户名 -> (分数, 时间)
+        std::set<std::tuple<int, int64_t, std::string>> ordered;    // (-分数, 时间, 用户名)
+        
+        void upsert(const std::string& name, int score, int64_t timestamp);
+        void reset(long id);
+    };
+    
+    Board daily_;
+    Board weekly_;
+    std::vector<PeriodRollup> rollups_;
+    
+    // 把榜单压缩为汇总并清空
+    void rollUp(Board& board);
+    void addRollup(const PeriodRollup& rollup);
+};
+
+#endif // PERIODRANKS_H
@@ -0,0 +1,117 @@
+#ifndef PLAYERSTATS_H
+#define PLAYERSTATS_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "StringPool.h"
+
+// 单个玩家的统计（查询结果）
+struct PlayerStatRow {
+    std::string_view username;
+    uint32_t gamesPlayed;
+    uint64_t totalScore;
+    uint32_t bestScore;
+    uint32_t maxTile;
+    uint64_t totalMoves;
+    
+    double averageScore() const { return gamesPlayed == 0 ? 0.0 : static_cast<double>(totalScore) / gamesPlayed; }
+};
+
+// 全体玩家的汇总报表（只扫描列数组）
+struct PlayerStatSummary {
+    uint32_t players = 0;
+    uint64_t gamesPlayed = 0;
+    uint64_t totalScore = 0;
+    uint64_t totalMoves = 0;
+    uint32_t maxTile = 0;
+    uint32_t playersByMaxTile[18] = {};  // 按最大方块 log2 计数（下标1 = 2，11 = 2048）
+};
+
+// 玩家统计存储：列式二进制文件，每个指标一个数组，以用户名id为下标
+//
+// stats.bin 布局（内存映射，MAP_SHARED 读写）：
+//   [头部 64字节][总分 u64 x 容量][总步数 u64 x 容量][局数 u32 x 容量][最高分 u32 x 容量][最大方块 u32 x 容量]
+// stats.bin.names 每行一个用户名，行号即id（只追加）
+//
+// 更新一个玩家只改写映射中的几个字，不重写文件；容量不足时翻倍重建（临时文件 + rename）。
+// 写入在 stats.bin.lock 上持有排他 flock，多个实例可以共享同一份统计。
+// 不加线程锁：调用方负责串行化。游戏中除启动时的 open 外，所有访问都经由 Game 的 io_ 串行队列执行。
+class PlayerStats {
+public:
+    PlayerStats(const std::string& filePath = "stats.bin");
+    ~PlayerStats();
+    
+    PlayerStats(const PlayerStats&) = delete;
+    PlayerStats& operator=(const PlayerStats&) = delete;
+    
+    // 映射统计文件（不存在则创建），失败返回false
+    bool open();
+    
+    // 记一局：局数+1，累加分数和步数，更新最高分和最大方块
+    bool recordGame(const std::string& username, int score, int maxTile, int moves);
+    
+    // 查询单个玩家，不存在返回false
+    bool get(const std::string& username, PlayerStatRow& out);
+    
+    // 扫描所有列生成汇总
+    PlayerStatSummary summarize();
+    
+    // 玩家数
+    size_t size();
+    
+    // 列数组（只读，长度为 size()），用于自定义扫描
+    const uint32_t* gamesColumn() const { return games_; }
+    const uint64_t* totalScoreColumn() const { return totalScore_; }
+    const uint32_t* bestScoreColumn() const { return bestScore_; }
+    const uint32_t* maxTileColumn() const { return maxTile_; }
+    const uint64_t* totalMovesColumn() const { return totalMoves_; }
+    std::string_view nameOf(uint32_t id) const { return names_.get(id); }
+    
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t count;
+        uint32_t reserved[11];
+    };
+    
+    std::string filePath_;
+    int fd_;
+    void* data_;
+    size_t mappedSize_;
+    unsigned long long mappedInode_;
+    
+    // 指向映射内各列的指针
+    Header* header_;
+    uint64_t* totalScore_;
+    uint64_t* totalMoves_;
+    uint32_t* games_;
+    uint32_t* bestScore_;
+    uint32_t* maxTile_;
+    
+    StringPool names_;      // id -> 用户名（与 names 文件的行号一致）
+    long long namesBytes_;  // 已读入的 names 文件字节数
+    
+    std::string namesFilePath() const;
+    std::string lockFilePath() const;
+    
+    static size_t fileSizeFor(uint32_t capacity);
+    
+    // 建立/解除映射并设置列指针
+    bool mapFile();
+    void unmapFile();
+    
+    // 并入其他进程的修改：文件被替换则重新映射，新玩家则读取 names 文件新增的行
+    bool syncUnlocked();
+    
+    // 容量翻倍：按新布局写临时文件后原子替换
+    bool growUnlocked(uint32_t capacity);
+    
+    // 新建空文件
+    bool createUnlocked(uint32_t capacity);
+};
+
+#endif // PLAYERSTATS_H
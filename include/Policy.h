@@ -0,0 +1,180 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "Board.h"
+#include "NTupleNetwork.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// 走子策略：输入局面（紧凑表示），输出方向
+// 任何提供下面两个成员的类型都是策略：
+//   bool choose(uint64_t packed, Direction& dir);   // 无合法方向返回false
+//   const char* name() const;
+// 作为模板参数传给 playGame 等函数时直接内联，没有虚函数调用；需要运行时选择时用 AnyPolicy 包装
+
+// 贪心：即时得分最大，相同时移动后空格多者优先
+struct GreedyPolicy {
+    const char* name() const { return "greedy"; }
+    
+    bool choose(uint64_t packed, Direction& dir) {
+        int best = -1, bestGain = -1, bestEmpty = -1;
+        for (int d = 0; d < 4; ++d) {
+            int gain = 0;
+            uint64_t after = Board::movePacked(packed, static_cast<Direction>(d), &gain);
+            if (after == packed) continue;
+            int empty = Board::emptyCount(after);
+            if (gain > bestGain || (gain == bestGain && empty > bestEmpty)) {
+                best = d;
+                bestGain = gain;
+                bestEmpty = empty;
+            }
+        }
+        if (best < 0) return false;
+        dir = static_cast<Direction>(best);
+        return true;
+    }
+};
+
+// 角落：把大方块压在左下角，按 下、左、右、上 的优先级取第一个合法方向
+struct CornerPolicy {
+    const char* name() const { return "corner"; }
+    
+    bool choose(uint64_t packed, Direction& dir) {
+        static const Direction kOrder[4] = {Direction::DOWN, Direction::LEFT, Direction::RIGHT, Direction::UP};
+        for (Direction candidate : kOrder) {
+            if (Board::movePacked(packed, candidate) != packed) {
+                dir = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// 随机：在合法方向中均匀选择（xorshift64，各实例独立）
+class RandomPolicy {
+public:
+    explicit RandomPolicy(uint64_t seed = 0x2048) : state_(seed | 1) {}
+    
+    const char* name() const { return "random"; }
+    
+    bool choose(uint64_t packed, Direction& dir) {
+        Direction legal[4];
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (Board::movePacked(packed, static_cast<Direction>(d)) != packed) {
+                legal[count++] = static_cast<Direction>(d);
+            }
+        }
+        if (count == 0) return false;
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        dir = legal[state_ % count];
+        return true;
+    }
+
+private:
+    uint64_t state_;
+};
+
+// 搜索：固定深度的期望最大化搜索（与走子提示相同），可选n元组网络估值
+class SearchPolicy {
+public:
+    explicit SearchPolicy(int depth = 2, const NTupleNetwork* network = nullptr);
+    
+    const char* name() const { return name_.c_str(); }
+    bool choose(uint64_t packed, Direction& dir);
+
+private:
+    int depth_;
+    const NTupleNetwork* network_;   // 不拥有
+    std::string name_;
+};
+
+// n元组网络一步贪心（网络不拥有，需比策略活得久）
+class NTuplePolicy {
+public:
+    explicit NTuplePolicy(const NTupleNetwork& network) : network_(&network) {}
+    
+    const char* name() const { return "n-tuple"; }
+    bool choose(uint64_t packed, Direction& dir) { return network_->bestMove(packed, dir); }
+
+private:
+    const NTupleNetwork* network_;
+};
+
+// 运行时选择的策略：包装任意策略类型，每次调用一次虚函数
+class AnyPolicy {
+public:
+    AnyPolicy() = default;
+    
+    template <typename Policy,
+              typename = typename std::enable_if<!std::is_same<typename std::decay<Policy>::type, AnyPolicy>::value>::type>
+    AnyPolicy(Policy policy)
+        : impl_(new Model<Policy>(std::move(policy))) {}
+    
+    explicit operator bool() const { return impl_ != nullptr; }
+    const char* name() const { return impl_ ? impl_->name() : "none"; }
+    bool choose(uint64_t packed, Direction& dir) { return impl_ && impl_->choose(packed, dir); }
+
+private:
+    struct Concept {
+        virtual ~Concept() = default;
+        virtual bool choose(uint64_t packed, Direction& dir) = 0;
+        virtual const char* name() const = 0;
+    };
+    
+    template <typename Policy>
+    struct Model final : Concept {
+        Policy policy;
+        explicit Model(Policy p) : policy(std::move(p)) {}
+        bool choose(uint64_t packed, Direction& dir) override { return policy.choose(packed, dir); }
+        const char* name() const override { return policy.name(); }
+    };
+    
+    std::unique_ptr<Concept> impl_;
+};
+
+// 按名字创建策略："greedy" "corner" "random" "search"（深度2）"search3"（深度3）"ntuple"
+// 搜索和 ntuple 使用 network（ntuple 需要非空）；未知名字返回空策略
+AnyPolicy makePolicy(const std::string& name, const NTupleNetwork* network = nullptr);
+
+// 一局的结果
+struct GameOutcome {
+    int score;
+    int moves;
+    int maxTile;
+};
+
+// 无界面对局：从两个随机方块开始按策略走到无法移动（或达到步数上限）
+// 策略作为模板参数，循环中的 choose 可以内联
+template <typename Policy>
+GameOutcome playGame(Policy& policy, uint64_t seed, int maxMoves = -1) {
+    uint64_t rng = seed;
+    uint64_t board = Board::spawnPacked(Board::spawnPacked(0, rng), rng);
+    GameOutcome outcome = {0, 0, 0};
+    Direction dir;
+    while (outcome.moves != maxMoves && policy.choose(board, dir)) {
+        int gain = 0;
+        uint64_t after = Board::movePacked(board, dir, &gain);
+        if (after == board) {
+            break;   // 策略给出了无效方向
+        }
+        outcome.score += gain;
+        ++outcome.moves;
+        board = Board::spawnPacked(after, rng);
+    }
+    int maxLog = 0;
+    for (int i = 0; i < 16; ++i) {
+        maxLog = std::max(maxLog, static_cast<int>((board >> (4 * i)) & 0xf));
+    }
+    outcome.maxTile = maxLog ? 1 << maxLog : 0;
+    return outcome;
+}
+
+#endif // POLICY_H
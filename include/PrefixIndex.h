@@ -0,0 +1,39 @@
+#ifndef PREFIXINDEX_H
+#define PREFIXINDEX_H
+
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "RankList.h"
+
+// 用户名前缀索引（用于菜单输入框自动补全）
+// 用户名按忽略大小写的字典序排序，前缀对应一段连续区间；
+// 区间内按分数取前k名用最大值线段树，单次查询 O(log n + k log k)
+class PrefixIndex {
+public:
+    PrefixIndex();
+    
+    // 从排行榜快照构建（持有快照，用户名直接引用快照内存，不复制）
+    void build(std::shared_ptr<const RankSnapshot> snapshot);
+    
+    // 构建所用快照的版本，0 表示尚未构建
+    uint64_t version() const;
+    
+    // 查询以prefix开头（忽略ASCII大小写）的用户名中分数最高的至多k个，按分数降序写入out
+    size_t complete(std::string_view prefix, size_t k, std::vector<RankEntryView>& out) const;
+    
+    size_t size() const { return entries_.size(); }
+    
+private:
+    std::shared_ptr<const RankSnapshot> snapshot_;
+    std::vector<RankEntryView> entries_;  // 按用户名排序
+    std::vector<uint32_t> tree_;          // 线段树：每个节点存区间内最高分条目的下标
+    size_t leaves_;
+    
+    // 区间 [lo, hi) 内最高分条目的下标
+    uint32_t maxIn(size_t lo, size_t hi) const;
+    uint32_t better(uint32_t a, uint32_t b) const;
+};
+
+#endif // PREFIXINDEX_H
@@ -2,16 +2,80 @@
 #define RANKLIST_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "StringPool.h"
+#include "ScoreSketch.h"
+#include "PeriodRanks.h"
 
-// 链表节点
+// 链表节点（所有节点存放在连续数组中，用下标链接）
 struct RankNode {
-    std::string username;
+    uint32_t nameId;  // 用户名在字符串池中的id
     int score;
-    RankNode* next;
+    int32_t next;     // 下一个节点的下标，-1 表示链表结尾
+    int64_t timestamp; // 取得该分数的时间（unix秒，0 表示未知）
+};
+
+// 排行榜只读视图条目（用户名指向所属快照的内存，不复制；快照存活期间有效）
+struct RankEntryView {
+    std::string_view username;
+    int score;
+    int rank;  // 名次（从1开始）
+};
+
+// 快照分块：一段连续名次的条目及其用户名，发布后不可变，可被多个版本的快照共享
+struct RankChunk {
+    struct Entry {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        int score;
+    };
+    
+    std::vector<char> names;     // 本块所有用户名首尾相接
+    std::vector<Entry> entries;  // 按名次排列
+    
+    std::string_view nameAt(size_t i) const {
+        return std::string_view(names.data() + entries[i].nameOffset, entries[i].nameLength);
+    }
+};
+
+// 排行榜不可变快照：由若干分块组成，发布后不再修改，任意线程可无锁读取
+// 写时复制只复制被修改的分块，其余分块与上一版本共享
+class RankSnapshot {
+public:
+    static const size_t PERIOD_TOP_SIZE = 10;  // 日榜/周榜发布的名次数
+    
+    RankSnapshot() : version_(0), size_(0) {}
+    
+    uint64_t version() const { return version_; }
+    size_t size() const { return size_; }
+    int getBestScore() const { return size_ == 0 ? 0 : chunks_.front()->entries.front().score; }
+    
+    // 分页读取：从第offset名开始取最多count条写入out（out会被清空后复用）
+    // 只返回视图，不复制字符串；返回实际取到的条数
+    size_t getPage(size_t offset, size_t count, std::vector<RankEntryView>& out) const;
     
-    RankNode(const std::string& name, int s) 
-        : username(name), score(s), next(nullptr) {}
+    // 指定时段的前 PERIOD_TOP_SIZE 名（ALL_TIME 即总榜第一页）；返回条数
+    size_t getPeriodTop(RankPeriod period, std::vector<RankEntryView>& out) const;
+    
+private:
+    friend class RankList;
+    
+    uint64_t version_;
+    size_t size_;
+    std::vector<std::shared_ptr<const RankChunk>> chunks_;
+    std::vector<size_t> chunkStart_;  // 每个分块第一条记录的名次下标
+    std::shared_ptr<const RankChunk> dailyTop_;   // 今日前N名
+    std::shared_ptr<const RankChunk> weeklyTop_;  // 本周前N名
+};
+
+// 分数分布的统计时段（按本地自然日）
+enum class ScorePeriod {
+    TODAY,        // 今天
+    LAST_7_DAYS   // 最近7天（含今天）
 };
 
 class RankList {
@@ -19,40 +83,171 @@ public:
     RankList(const std::string& rankFilePath = "ranks.txt");
     ~RankList();
     
-    // 从文件加载排行榜
+    // 从文件加载排行榜（内存映射 + from_chars 解析，再回放更新日志）
     void load();
     
-    // 保存排行榜到文件
+    // 保存排行榜：只把变更追加到更新日志，日志过长时才整体重写（压缩）
     void save();
     
-    // 插入或更新（如果用户名存在且新分数更高则更新，否则插入）
+    // 立即压缩：重写主文件并清空更新日志
+    void compact();
+    
+    // 检查其他进程是否写过排行榜文件（三次stat），有变化则合并进来；
+    // 同时推进日榜/周榜时段，过期榜单在这里压缩，不占用查询路径；返回是否有更新
+    bool refreshIfChanged();
+    
+    // 插入或更新（如果用户名存在且新分数更高则更新，否则插入），同时计入日榜/周榜
     void insertOrUpdate(const std::string& username, int score);
     
+    // 批量插入或更新，只发布一次快照（模拟/导入等大批量写入用）
+    void insertOrUpdateBatch(const std::vector<std::pair<std::string, int>>& entries);
+    
     // 删除指定用户名的记录
     bool remove(const std::string& username);
     
-    // 获取最高分（用于显示Best Score）
+    // 获取当前快照（无锁，不会被写者阻塞；持有期间快照内容不变）
+    std::shared_ptr<const RankSnapshot> snapshot() const;
+    
+    // 获取最高分（用于显示Best Score，读快照）
     int getBestScore() const;
     
     // 获取指定用户的最高分
     int getUserScore(const std::string& username) const;
     
-    // 获取所有排名（用于显示排行榜）
+    // 获取所有排名（用于显示排行榜，读快照）
     std::vector<std::pair<std::string, int>> getAll() const;
     
+    // 获取记录总数（读快照）
+    size_t size() const;
+    
+    // 玩家最高分中低于score的比例 [0, 1]（"你超过了 X% 的玩家"），O(log 桶数)
+    double percentileOf(int score) const;
+    
+    // 最近的日榜/周榜汇总
+    std::vector<PeriodRollup> periodRollups() const;
+    
+    // 所有玩家最高分的分布草图（副本，可查询分位数/直方图）
+    ScoreSketch bestScoreSketch() const;
+    
+    // 指定时段内每局得分（每次 insertOrUpdate 记一局）的分布草图，只统计本进程
+    ScoreSketch gameScoreSketch(ScorePeriod period) const;
+    
     // 清空链表
     void clear();
     
 private:
-    RankNode* head_;
+    // 写者互斥：所有修改串行执行，读者只读已发布的快照，从不加这把锁
+    mutable std::mutex mutex_;
+    
+    // 当前发布的快照（通过 std::atomic_load/atomic_store 访问）
+    std::shared_ptr<const RankSnapshot> snapshot_;
+    uint64_t version_;
+    bool dirty_;         // 链表已修改但尚未发布快照
+    bool rebuildChunks_; // 批量修改后需要从链表整体重建分块
+    
+    // 写者维护的下一版本分块（与已发布快照共享未修改的分块）
+    std::vector<std::shared_ptr<const RankChunk>> chunks_;
+    
+
+    // 节点池：节点连续存放，删除的节点挂到空闲链表上复用
+    std::vector<RankNode> nodes_;
+    int32_t head_;
+    int32_t freeHead_;
+    
+    StringPool names_;                // 用户名驻留池
+    std::vector<int32_t> nodeOfName_; // 用户名id -> 节点下标（-1 表示不在榜上）
+    
     std::string rankFilePath_;
+    size_t count_;
+    
+    // 分数分布：榜上每个玩家的最高分，以及最近7天每天的逐局得分（按日环形复用）
+    struct DaySketch {
+        long day = -1;
+        ScoreSketch sketch;
+    };
+    ScoreSketch bestScores_;
+    std::vector<DaySketch> recentDays_;
+    
+    // 记一局得分到当天的草图
+    void recordGame(int score);
+    
+    // 日榜/周榜（持久化到 ranks.txt.periods）
+    PeriodRanks periods_;
+    bool periodsDirty_;     // 有未落盘的时段记录或压缩
+    bool periodTopStale_;   // 需要重新发布日榜/周榜前N名
+    std::shared_ptr<const RankChunk> dailyTop_;
+    std::shared_ptr<const RankChunk> weeklyTop_;
+    
+    // 增量持久化：未落盘的变更（score < 0 表示删除），以及日志中已有的条数
+    struct PendingRecord {
+        uint32_t nameId;
+        int score;
+        int64_t timestamp;
+    };
+    std::vector<PendingRecord> pendingLog_;
+    size_t logEntries_;
+    bool rewritePending_;  // clear() 之后必须整体重写
+    
+    // 文件标识（inode + 大小 + 修改时间），用于低成本判断文件是否被其他进程改写
+    struct FileStamp {
+        unsigned long long inode = 0;
+        long long size = -1;
+        long long mtime = 0;
+        
+        static FileStamp of(const std::string& path);
+        bool operator==(const FileStamp& other) const {
+            return inode == other.inode && size == other.size && mtime == other.mtime;
+        }
+    };
+    
+    // 已同步到内存的磁盘状态
+    FileStamp syncedMain_;
+    long long syncedLogSize_;
+    FileStamp syncedPeriods_;
+    
+    std::string logFilePath() const;
+    std::string lockFilePath() const;
+    std::string periodFilePath() const;
+    
+    // 以下 *Unlocked 函数要求调用者已持有 mutex_ 和文件锁
+    void loadUnlocked();
+    void compactUnlocked();
+    
+    // 并入其他进程写入的更新：日志增长只读尾部，主文件被替换则整体重新加载
+    bool catchUpUnlocked();
+    
+    // 时段文件被其他进程改写时合并进来；返回是否有变化
+    bool mergePeriodsUnlocked();
+    
+    // 写出时段文件（调用者持有排他文件锁，且已合并过磁盘上的内容）
+    void savePeriodsUnlocked();
+    
+    // 按日志规则合并一条记录（分数取最大值，负数表示删除）
+    void mergeRecord(std::string_view name, int score, int64_t timestamp);
+    
+    // 插入或提高分数，返回是否有变化
+    bool upsertMax(uint32_t nameId, int score, int64_t timestamp);
+    
+    // 链表有修改时生成新快照并原子发布（调用者持有 mutex_）
+    void publishIfDirty();
+    
+    // 在分块中按名次插入/删除一条记录（写时复制受影响的分块）
+    void chunkInsert(size_t rank, uint32_t nameId, int score);
+    void chunkErase(size_t rank);
+    
+    void clearUnlocked();
+    
+    // 从节点池分配一个节点
+    int32_t allocNode(uint32_t nameId, int score, int64_t timestamp);
     
     // 插入节点到链表的正确位置（按分数降序）
-    void insertNode(RankNode* node);
+    void insertNode(int32_t node);
+    
+    // 从链表中摘除节点并归还节点池（不记录日志）
+    bool removeNode(uint32_t nameId);
     
-    // 查找节点
-    RankNode* findNode(const std::string& username);
+    // 查找节点，不存在返回-1
+    int32_t findNode(uint32_t nameId) const;
 };
 
 #endif // RANKLIST_H
-
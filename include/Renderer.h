@@ -5,11 +5,13 @@
 #include <string>
 #include <vector>
 #include "MoveEvent.h"
+#include "RankList.h"
 
 class Board;
-class Menu;
-class RankList;
+struct MenuView;
 struct Button;  // 前置声明
+struct Hint;
+struct FrameSnapshot;
 
 class Renderer {
 public:
@@ -18,25 +20,30 @@ public:
     // 初始化（加载字体等）
     bool init();
     
+    // 按快照绘制一帧（渲染线程调用，只读快照）
+    void renderFrame(const FrameSnapshot& frame);
+    
     // 绘制整个游戏界面
     void render(const Board& board, 
                 const std::vector<VisualTile>& visualTiles,
                 const std::string& username,
                 int bestScore,
-                const std::string& statusText);
+                const std::string& statusText,
+                const std::string& detailText = "",
+                const Hint* hint = nullptr);
     
     // 绘制增强版菜单界面（支持文本输入和鼠标交互）
-    void renderMenu(const Menu& menu);
+    void renderMenu(const MenuView& menu);
     
     // 绘制排行榜界面
-    void renderRankList(const RankList& rankList, const Menu& menu);
+    void renderRankList(const RankSnapshot& snapshot, const MenuView& menu);
     
     // 获取网格参数（供Animator使用）
     float getCellSize() const { return cellSize_; }//获取单元格尺寸
     float getPadding() const { return padding_; }//获取网格间距
     float getGridStartX() const { return gridStartX_; }//获取网格起始X坐标
     float getGridStartY() const { return gridStartY_; }//获取网格起始Y坐标
-    
+
 private:
     sf::RenderWindow& window_;//窗口
     sf::Font font_;//字体
@@ -46,13 +53,16 @@ private:
     float gridStartY_;//网格起始Y坐标
     float padding_;//网格间距
     
+    std::vector<RankEntryView> rankPage_;//排行榜当前页（复用，避免每帧分配）
+    
     // 绘制辅助函数
     void drawBackground();//绘制背景
     void drawGrid();//绘制网格
     void drawTile(int row, int col, int value, float scale = 1.0f);//绘制方块
     void drawTileAt(float x, float y, int value, float scale = 1.0f);//绘制方块
     void drawUI(const std::string& username, int score, int bestScore, 
-                const std::string& statusText);//绘制UI
+                const std::string& statusText, const std::string& detailText);//绘制UI
+    void drawHint(const Hint& hint);//绘制提示箭头和置信度
     
     // 获取方块颜色
     sf::Color getTileColor(int value) const;
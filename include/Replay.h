@@ -0,0 +1,66 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Board.h"
+
+// 对局回放：起始局面 + 随机数状态 + 每步2位方向
+// 新方块不存储，由 Board 的随机数状态重新生成，20000步约5KB
+//
+// 文件格式（小端）：
+//   "2048RPL1" | 随机数状态 u64 | 时间 i64 | 起始分数 u32 | 最终分数 u32 | 步数 u32
+//   | 起始网格 16 x u8（log2，0为空）| 用户名长度 u16 | 用户名 | 方向 ceil(步数/4) 字节
+// 方向编码与 Direction 枚举一致（UP=0, DOWN=1, LEFT=2, RIGHT=3），每字节低位在前
+class Replay {
+public:
+    Replay();
+    
+    // 从当前局面开始录制（新游戏在 init 之后调用，继续存档在加载之后调用）
+    void begin(const std::string& username, const Board& board);
+    
+    // 追加一步有效移动
+    void append(Direction dir);
+    
+    // 丢弃第 moveCount 步之后的记录（撤销时调用）
+    void truncate(size_t moveCount);
+    
+    // 结束录制，记录最终分数和时间
+    void finish(int finalScore, int64_t timestamp);
+    
+    size_t moveCount() const { return moveCount_; }
+    Direction moveAt(size_t index) const {
+        return static_cast<Direction>((moves_[index >> 2] >> ((index & 3) * 2)) & 3);
+    }
+    
+    const std::string& username() const { return username_; }
+    int startScore() const { return startScore_; }
+    int finalScore() const { return finalScore_; }
+    int64_t timestamp() const { return timestamp_; }
+    
+    // 还原起始局面（网格、分数、随机数状态）
+    void startBoard(Board& board) const;
+    
+    // 从起始局面回放全部步数，返回最终局面；有无效移动（文件损坏）返回false
+    bool play(Board& board) const;
+    
+    // 序列化
+    std::vector<char> encode() const;
+    bool decode(const char* data, size_t size);
+    bool writeTo(const std::string& path) const;
+    bool readFrom(const std::string& path);
+    
+private:
+    std::string username_;
+    uint64_t rngState_;
+    int64_t timestamp_;
+    int startScore_;
+    int finalScore_;
+    uint8_t startGrid_[16];
+    size_t moveCount_;
+    std::vector<uint8_t> moves_;  // 每字节4步
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,45 @@
+#ifndef REPLAYPLAYER_H
+#define REPLAYPLAYER_H
+
+#include <cstddef>
+#include <vector>
+#include "Board.h"
+#include "Replay.h"
+
+// 回放播放器：加载时每 KEYFRAME_INTERVAL 步保存一份完整局面（网格 + 分数 + 随机数状态）
+// 跳转到任意一步时从不超过目标的最近关键帧出发，最多重放 KEYFRAME_INTERVAL 步
+class ReplayPlayer {
+public:
+    static const size_t KEYFRAME_INTERVAL = 256;
+    
+    ReplayPlayer();
+    
+    // 加载回放并建立关键帧索引（完整回放一遍），回放无效返回false
+    bool load(const Replay& replay);
+    bool load(const std::string& path);
+    
+    const Replay& replay() const { return replay_; }
+    
+    // 当前局面：已执行 position() 步之后的状态
+    const Board& board() const { return board_; }
+    size_t position() const { return position_; }
+    size_t length() const { return replay_.moveCount(); }
+    bool atEnd() const { return position_ >= replay_.moveCount(); }
+    
+    // 下一步的方向（atEnd() 时无意义）
+    Direction nextMove() const { return replay_.moveAt(position_); }
+    
+    // 前进一步，已到结尾返回false
+    bool step();
+    
+    // 跳转到第 move 步之后的局面（超出范围则夹到结尾）
+    void seek(size_t move);
+    
+private:
+    Replay replay_;
+    std::vector<Board> keyframes_;  // keyframes_[i] 为第 i * KEYFRAME_INTERVAL 步之后的局面
+    Board board_;
+    size_t position_;
+};
+
+#endif // REPLAYPLAYER_H
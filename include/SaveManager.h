@@ -4,6 +4,7 @@
 #include <string>
 
 class Board;
+class Replay;
 
 class SaveManager {
 public:
@@ -18,11 +19,20 @@ public:
     // 检查保存文件是否存在
     bool hasSave() const;
     
-    // 删除保存文件
+    // 删除保存文件（连同未完成的回放）
     void deleteSave();
     
+    // 保存/加载未完成对局的回放，继续游戏后接着录制
+    bool saveReplay(const Replay& replay);
+    bool loadReplay(Replay& replay);
+    
+    // 只删除未完成的回放（对局无法再由回放重现时）
+    void deleteReplay();
+    
 private:
     std::string saveFilePath_;
+    
+    std::string replayFilePath() const;
 };
 
 #endif // SAVEMANAGER_H
@@ -0,0 +1,49 @@
+#ifndef SCORESKETCH_H
+#define SCORESKETCH_H
+
+#include <vector>
+#include <cstdint>
+
+// 分数分布草图（对数分桶，类似 DDSketch）
+// 相邻桶边界相差 2%，任意分位数的相对误差不超过 1%；
+// 桶计数用树状数组维护，插入/删除、排名、分位数都是 O(log 桶数)，与样本数无关
+class ScoreSketch {
+public:
+    ScoreSketch();
+    
+    // 加入一个分数（count 为负表示移除之前加入的分数）
+    void add(int score, int count = 1);
+    
+    // 合并另一个草图
+    void merge(const ScoreSketch& other);
+    
+    void clear();
+    
+    // 样本总数
+    uint64_t count() const { return total_; }
+    
+    // 低于score的样本比例 [0, 1]（与score同桶的样本不计入，误差在1%分数范围内）
+    double rankOf(int score) const;
+    
+    // 第q分位数（q ∈ [0, 1]），空草图返回0
+    int quantile(double q) const;
+    
+    // 按给定分界 edges（升序）统计直方图：out[i] 为 [edges[i], edges[i+1]) 中的样本数，
+    // out 比 edges 多一个末尾区间 [edges.back(), +∞)
+    void histogram(const std::vector<int>& edges, std::vector<uint64_t>& out) const;
+    
+private:
+    static const int kBuckets = 1024;
+    
+    std::vector<int64_t> counts_;  // 每桶样本数
+    std::vector<int64_t> tree_;    // 树状数组（1-based）
+    uint64_t total_;
+    
+    static int bucketOf(int score);
+    static int bucketValue(int bucket);  // 桶的代表值
+    
+    // 前 bucket 个桶（不含 bucket）的样本数
+    int64_t countBelow(int bucket) const;
+};
+
+#endif // SCORESKETCH_H
@@ -0,0 +1,80 @@
+#ifndef SMALLSOLVER_H
+#define SMALLSOLVER_H
+
+#include "Board.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 一个局面的求解结果（32字节）：三种策略从该局面起的期望得分，以及最优方向（最小表示的朝向）
+struct SmallSolution {
+    double optimal;   // 最优策略
+    double greedy;    // 贪心：即时得分最大，相同时空格多者优先
+    double random;    // 在合法方向中均匀随机
+    uint8_t dir;      // 最优方向，无法移动时为 0xff
+    uint8_t reserved[7];
+};
+
+struct SmallSolverResult {
+    uint64_t states;             // 可达局面数（按对称合并）
+    int layers;                  // 层数（按方块总和分层）
+    uint64_t largestLayer;
+    uint64_t moves;              // 正向展开执行的移动次数
+    uint64_t kernelMismatches;   // 批量内核与 movePacked 结果不一致的次数
+    double expandSeconds;
+    double solveSeconds;
+    double optimalScore;         // 开局（两个随机方块）时的期望最终得分
+    double greedyScore;
+    double randomScore;
+};
+
+// 小棋盘（2x2 ~ 4x3，如 3x3、2x3）的精确求解：枚举所有可达局面，动态规划求最优策略和期望最终得分
+// 小棋盘放在 Board 紧凑表示的左上角，区域外的格子恒为0；向左/向上直接用 Board::movePacked，
+// 向右/向下先把区域平移到右/下边缘再移动、移回，区域内的方块不会越界
+// 每次生成新方块方块总和增加2或4，移动不改变总和，所以按总和分层：
+//   正向：从小到大逐层展开（多线程分块），子局面追加到目标层的磁盘文件，轮到该层时排序去重后写成有序键文件
+//   反向：从大到小逐层求值，每层只需映射总和+2、+4两层的键和结果，内存占用与最大的三层相当
+// 工作目录中每层两个文件: s<总和>.keys（有序的 u64 局面）和 s<总和>.sol（SmallSolution 数组）
+class SmallSolver {
+public:
+    SmallSolver(int rows, int cols);
+    
+    bool isValid() const;
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    
+    void setThreads(int threads);
+    void setWorkDir(const std::string& dir);
+    // 正向展开改用 BoardBatch 批量移动，并逐个与 movePacked 核对（移动内核的压力测试）
+    void setUseBatch(bool useBatch);
+    
+    // 正向枚举 + 反向求值；结果文件留在工作目录
+    bool run(SmallSolverResult& result);
+    
+    // 求解后：按已求出的期望值选最优方向（任意朝向的局面都可以）；局面不可达或无法移动返回false
+    bool bestMove(uint64_t packed, Direction& dir, double* value = nullptr) const;
+    
+    // 小棋盘上的移动和最小表示（正方形8种对称，长方形4种）
+    uint64_t move(uint64_t packed, Direction dir, int* scoreGain = nullptr) const;
+    uint64_t canonical(uint64_t packed) const;
+    
+    static int tileSum(uint64_t packed);
+
+private:
+    int rows_;
+    int cols_;
+    int threads_;
+    bool useBatch_;
+    std::string workDir_;
+    std::vector<int> layerSums_;   // 已展开的层（升序）
+    
+    std::string keysPath(int sum) const;
+    std::string solutionPath(int sum) const;
+    std::string pendingPath(int sum) const;
+    
+    bool expand(SmallSolverResult& result);
+    bool solve(SmallSolverResult& result);
+    bool initialScores(SmallSolverResult& result) const;
+};
+
+#endif // SMALLSOLVER_H
@@ -0,0 +1,55 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// 单生产者单消费者环形队列（固定容量，不分配内存，不加锁）
+// 生产者只写 head_，消费者只写 tail_；各自缓存对方的位置，只有看起来满/空时才重新读取对方的原子变量
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "容量必须是2的幂");
+
+public:
+    SpscQueue() : head_(0), tailCache_(0), tail_(0), headCache_(0) {}
+    
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    
+    // 生产者：队列满时返回false（不等待）
+    bool push(const T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tailCache_ == Capacity) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head - tailCache_ == Capacity) {
+                return false;
+            }
+        }
+        slots_[head & (Capacity - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // 消费者：队列空时返回false
+    bool pop(T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == headCache_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail == headCache_) {
+                return false;
+            }
+        }
+        value = slots_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T slots_[Capacity];
+    alignas(64) std::atomic<size_t> head_;   // 下一个写入位置（生产者）
+    size_t tailCache_;                       // 生产者看到的读取位置
+    alignas(64) std::atomic<size_t> tail_;   // 下一个读取位置（消费者）
+    size_t headCache_;                       // 消费者看到的写入位置
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,42 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 字符串驻留池：所有字符串连续存放在一块缓冲区中，用紧凑的32位id引用
+// 同一字符串只存一份；id 在 clear() 之前保持不变
+class StringPool {
+public:
+    static const uint32_t npos = 0xFFFFFFFFu;
+    
+    StringPool();
+    
+    // 预留空间（批量加载前调用，避免反复扩容）
+    void reserve(size_t strings, size_t bytes);
+    
+    // 驻留字符串，返回其id（已存在则返回原id）
+    uint32_t intern(std::string_view str);
+    
+    // 查找字符串id，不存在返回npos
+    uint32_t find(std::string_view str) const;
+    
+    // 按id取字符串（视图在下一次intern之前有效）
+    std::string_view get(uint32_t id) const;
+    
+    size_t size() const { return offsets_.size() - 1; }
+    void clear();
+    
+private:
+    std::vector<char> chars_;        // 所有字符串首尾相接
+    std::vector<uint32_t> offsets_;  // 第i个字符串位于 [offsets_[i], offsets_[i+1])
+    std::vector<uint32_t> slots_;    // 开放寻址哈希表，存 id+1，0 表示空
+    
+    static uint64_t hash(std::string_view str);
+    size_t findSlot(std::string_view str, uint64_t h) const;
+    void rehash(size_t slotCount);
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,49 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// 三缓冲：一个写线程不断发布整份数据，一个读线程随时取最新的一份，双方都不加锁、不等待
+// 三个槽位分别归写方（back）、读方（front）和中转（middle）所有：
+//   写方在 back 中写完后 publish，把 back 与 middle 交换，并标记 middle 为未读
+//   读方 read 时如果 middle 未读，就把 front 与 middle 交换；否则继续使用上一次的 front
+// 交换只是对一个原子字节的 exchange（低2位为槽位下标，第3位为未读标记）
+// 写方比读方快时中间的版本直接被覆盖，读方比写方快时重复读到同一版本
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle_(1), back_(2), front_(0) {}
+    
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+    
+    // 写方：当前可写的槽位（内容是更早发布过的旧版本，需要完整覆盖）
+    T& writeBuffer() { return slots_[back_]; }
+    
+    // 写方：发布刚写好的槽位，换回一个读方不再使用的槽位
+    void publish() {
+        uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+    }
+    
+    // 读方：取最新发布的数据（没有新数据时返回上一次读到的）
+    const T& read() {
+        if (middle_.load(std::memory_order_relaxed) & kFresh) {
+            uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = previous & kIndexMask;
+        }
+        return slots_[front_];
+    }
+
+private:
+    static const uint8_t kIndexMask = 3;
+    static const uint8_t kFresh = 4;
+    
+    T slots_[3];
+    alignas(64) std::atomic<uint8_t> middle_;   // 中转槽位下标 | 未读标记
+    alignas(64) uint8_t back_;                  // 只有写方访问
+    alignas(64) uint8_t front_;                 // 只有读方访问
+};
+
+#endif // TRIPLE_BUFFER_H
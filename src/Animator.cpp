@@ -10,6 +10,8 @@ Animator::Animator()
       moveDuration_(0.2f),
       mergeDuration_(0.1f),
       spawnDuration_(0.1f),
+      timeScale_(1.0f),
+      skipInterpolation_(false),
       cellSize_(100.0f),
       padding_(10.0f),
       gridStartX_(0.0f),
@@ -28,7 +30,7 @@ void Animator::startMoveAnimation(const std::vector<MoveEvent>& events,
     (void)currentGrid; // 当前暂未使用，可用于校验
 
     visualTiles_.clear();
-    if (events.empty()) {
+    if (events.empty() || skipInterpolation_) {
         isAnimating_ = false;
         animationTime_ = 0.0f;
         return;
@@ -72,11 +74,28 @@ void Animator::startMoveAnimation(const std::vector<MoveEvent>& events,
     animationTime_ = 0.0f;
 }
 
+void Animator::startReverseMoveAnimation(const std::vector<MoveEvent>& events) {
+    // 交换起点和终点，全部按普通移动处理（不做合并弹出）
+    std::vector<MoveEvent> reversed;
+    reversed.reserve(events.size());
+    for (const auto& event : events) {
+        MoveEvent back = event;
+        back.fromRow = event.toRow;
+        back.fromCol = event.toCol;
+        back.toRow = event.fromRow;
+        back.toCol = event.fromCol;
+        back.type = EventType::MOVE;
+        reversed.push_back(back);
+    }
+    
+    startMoveAnimation(reversed, nullptr);
+}
+
 void Animator::startSpawnAnimation(int row, int col, int value) {
 
     visualTiles_.clear();
 
-    if (value <= 0) {
+    if (value <= 0 || skipInterpolation_) {
         isAnimating_ = false;
         animationTime_ = 0.0f;
         return;
@@ -111,7 +130,7 @@ void Animator::update(float deltaTime) {
     if (deltaTime < 0.0f) deltaTime = 0.0f;
     if (deltaTime > 0.1f)  deltaTime = 0.1f; // 限制最大dt，避免跳帧鬼畜
 
-    animationTime_ += deltaTime;
+    animationTime_ += deltaTime * timeScale_;
 
     bool allComplete = true;
 
@@ -213,6 +232,27 @@ void Animator::stop() {
     visualTiles_.clear();
 }
 
+void Animator::setPlaybackRate(float movesPerSecond, float displayRate) {
+    timeScale_ = std::max(1.0f, movesPerSecond / baseMovesPerSecond());
+    skipInterpolation_ = movesPerSecond > displayRate;
+    if (skipInterpolation_) {
+        stop();
+    }
+}
+
+void Animator::resetPlaybackRate() {
+    timeScale_ = 1.0f;
+    skipInterpolation_ = false;
+}
+
+bool Animator::isSkippingInterpolation() const {
+    return skipInterpolation_;
+}
+
+float Animator::baseMovesPerSecond() const {
+    return 1.0f / (moveDuration_ + mergeDuration_ + spawnDuration_);
+}
+
 void Animator::gridToPixel(int row, int col, float& x, float& y) const {
     // 关键修复：每个单元格占用 (cellSize_ + padding_) 的空间
     x = gridStartX_ + static_cast<float>(col) * (cellSize_ + padding_);
@@ -1,17 +1,106 @@
 #include "Board.h"
 #include <cstring>
-#include <cstdlib>
-#include <ctime>
 #include <algorithm>
+#include <chrono>
+#include <random>
 
-Board::Board() : score_(0) {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+namespace {
+
+// Zobrist 随机键：每个格子 x 每种数值（log2 0~17）一个64位键，空格为0
+struct ZobristTable {
+    uint64_t keys[16][18];
+    
+    ZobristTable() {
+        uint64_t state = 0x2048204820482048ULL;  // 固定种子，哈希值跨进程/跨运行稳定
+        for (int cell = 0; cell < 16; ++cell) {
+            keys[cell][0] = 0;
+            for (int log = 1; log < 18; ++log) {
+                uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                keys[cell][log] = z ^ (z >> 31);
+            }
+        }
+    }
+};
+
+const ZobristTable kZobrist;
+
+// 行移动表：一行16位（第0列在低4位），向左移动后的结果和得分；向右由反转得到
+struct RowTable {
+    uint16_t left[65536];
+    uint16_t right[65536];
+    uint32_t score[65536];
+    
+    static uint16_t reverse(uint16_t row) {
+        return static_cast<uint16_t>((row >> 12) | ((row >> 4) & 0x00f0) | ((row << 4) & 0x0f00) | (row << 12));
+    }
+    
+    RowTable() {
+        for (uint32_t row = 0; row < 65536; ++row) {
+            int line[4];
+            for (int c = 0; c < 4; ++c) {
+                line[c] = (row >> (4 * c)) & 0xf;
+            }
+            int out[4] = {0, 0, 0, 0};
+            int count = 0;
+            uint32_t gain = 0;
+            bool merged = false;
+            for (int c = 0; c < 4; ++c) {
+                if (line[c] == 0) continue;
+                if (count > 0 && !merged && out[count - 1] == line[c] && line[c] < 15) {
+                    ++out[count - 1];
+                    gain += 1u << out[count - 1];
+                    merged = true;
+                } else {
+                    out[count++] = line[c];
+                    merged = false;
+                }
+            }
+            uint16_t result = 0;
+            for (int c = 0; c < 4; ++c) {
+                result |= static_cast<uint16_t>(out[c] << (4 * c));
+            }
+            left[row] = result;
+            score[row] = gain;
+        }
+        for (uint32_t row = 0; row < 65536; ++row) {
+            right[row] = reverse(left[reverse(static_cast<uint16_t>(row))]);
+        }
+    }
+};
+
+const RowTable kRows;
+
+// splitmix64 的步长（奇数，模 2^64 可逆）
+const uint64_t kRngIncrement = 0x9e3779b97f4a7c15ULL;
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += kRngIncrement);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t zobristKey(int cell, int value) {
+    return value == 0 ? 0 : kZobrist.keys[cell][std::min(__builtin_ctz(static_cast<unsigned>(value)), 17)];
+}
+
+} // namespace
+
+Board::Board() : score_(0), rngState_(randomSeed()), hash_(0) {
     std::memset(grid_, 0, sizeof(grid_));
 }
 
 void Board::init() {
+    init(randomSeed());
+}
+
+void Board::init(uint64_t seed) {
     std::memset(grid_, 0, sizeof(grid_));
     score_ = 0;
+    rngState_ = seed;
+    hash_ = 0;
     
     // 正常模式：生成两个随机初始方块
     spawnNewTile();
@@ -24,6 +113,7 @@ void Board::getGrid(int outGrid[4][4]) const {
 
 void Board::setGrid(const int inGrid[4][4]) {
     copyGrid(inGrid, grid_);
+    rehash();
 }
 
 int Board::getValue(int row, int col) const {
@@ -56,28 +146,225 @@ MoveResult Board::simulateMove(Direction dir) const {
 }
 
 void Board::commitGrid(const int newGrid[4][4]) {
+    // 只对变化的格子更新哈希
+    for (int i = 0; i < 16; ++i) {
+        int oldValue = grid_[i / 4][i % 4];
+        int newValue = newGrid[i / 4][i % 4];
+        if (oldValue != newValue) {
+            hash_ ^= zobristKey(i, oldValue) ^ zobristKey(i, newValue);
+        }
+    }
     copyGrid(newGrid, grid_);
 }
 
 std::pair<std::pair<int, int>, int> Board::spawnNewTile() {
-    auto emptyCells = getEmptyCells();
+    int cells[16];
+    int emptyCount = getEmptyCells(cells);
     
-    if (emptyCells.empty()) {
+    if (emptyCount == 0) {
         return {{-1, -1}, 0};
     }
     
-    // 随机选择空位置
-    int index = std::rand() % emptyCells.size();
-    auto pos = emptyCells[index];
+    // 一次取64位随机数：高32位乘法映射选位置（不做除法），低32位决定数值
+    uint64_t random = nextRandom();
+    int cell = cells[((random >> 32) * static_cast<uint64_t>(emptyCount)) >> 32];
     
     // 90% 概率生成2，10% 概率生成4
-    int value = (std::rand() % 10 == 0) ? 4 : 2;
+    int value = (random & 0xffffffffu) < 0x1999999au ? 4 : 2;
     
+    std::pair<int, int> pos = {cell / 4, cell % 4};
     grid_[pos.first][pos.second] = value;
+    hash_ ^= zobristKey(cell, value);
     
     return {pos, value};
 }
 
+bool Board::placeTile(int row, int col, int value) {
+    if (row < 0 || row >= 4 || col < 0 || col >= 4 || grid_[row][col] != 0) {
+        return false;
+    }
+    grid_[row][col] = value;
+    hash_ ^= zobristKey(row * 4 + col, value);
+    return true;
+}
+
+bool Board::applyMove(Direction dir) {
+    MoveResult result = simulateMove(dir);
+    if (!result.changed) {
+        return false;
+    }
+    
+    commitGrid(result.grid);
+    addScore(result.scoreGain);
+    spawnNewTile();
+    return true;
+}
+
+void Board::seed(uint64_t seed) {
+    rngState_ = seed;
+}
+
+uint64_t Board::getRngState() const {
+    return rngState_;
+}
+
+void Board::setRngState(uint64_t state) {
+    rngState_ = state;
+}
+
+uint64_t Board::randomSeed() {
+    std::random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+    return seed ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+namespace {
+
+// 步长的模 2^64 逆元
+uint64_t inverseOf(uint64_t odd) {
+    // 牛顿迭代求模 2^64 逆元，每次迭代正确位数翻倍
+    uint64_t inverse = odd;
+    for (int i = 0; i < 5; ++i) {
+        inverse *= 2 - odd * inverse;
+    }
+    return inverse;
+}
+
+} // namespace
+
+uint64_t Board::rngDistance(uint64_t from, uint64_t to) {
+    static const uint64_t inverse = inverseOf(kRngIncrement);
+    return (to - from) * inverse;
+}
+
+uint64_t Board::rngAdvance(uint64_t state, uint64_t draws) {
+    return state + draws * kRngIncrement;
+}
+
+bool Board::pack(uint64_t& packed) const {
+    packed = 0;
+    for (int i = 0; i < 16; ++i) {
+        int value = grid_[i / 4][i % 4];
+        uint64_t log = 0;
+        while (value > 1) {
+            value >>= 1;
+            ++log;
+        }
+        if (log > 15) {
+            return false;
+        }
+        packed |= log << (4 * i);
+    }
+    return true;
+}
+
+void Board::unpack(uint64_t packed) {
+    for (int i = 0; i < 16; ++i) {
+        int log = static_cast<int>((packed >> (4 * i)) & 0xf);
+        grid_[i / 4][i % 4] = log == 0 ? 0 : 1 << log;
+    }
+    rehash();
+}
+
+void Board::rehash() {
+    hash_ = 0;
+    for (int i = 0; i < 16; ++i) {
+        hash_ ^= zobristKey(i, grid_[i / 4][i % 4]);
+    }
+}
+
+uint64_t Board::hashOf(uint64_t packed) {
+    uint64_t hash = 0;
+    for (int i = 0; i < 16; ++i, packed >>= 4) {
+        hash ^= kZobrist.keys[i][packed & 0xf];
+    }
+    return hash;
+}
+
+uint64_t Board::transpose(uint64_t x) {
+    // 先交换每个2x2块内的对角，再交换2x2块本身
+    uint64_t a1 = x & 0xF0F00F0FF0F00F0FULL;
+    uint64_t a2 = x & 0x0000F0F00000F0F0ULL;
+    uint64_t a3 = x & 0x0F0F00000F0F0000ULL;
+    uint64_t a = a1 | (a2 << 12) | (a3 >> 12);
+    uint64_t b1 = a & 0xFF00FF0000FF00FFULL;
+    uint64_t b2 = a & 0x00FF00FF00000000ULL;
+    uint64_t b3 = a & 0x00000000FF00FF00ULL;
+    return b1 | (b2 >> 24) | (b3 << 24);
+}
+
+uint64_t Board::mirror(uint64_t x) {
+    // 每行16位内反转4个半字节
+    return ((x & 0x000F000F000F000FULL) << 12) | ((x & 0x00F000F000F000F0ULL) << 4) |
+           ((x & 0x0F000F000F000F00ULL) >> 4) | ((x & 0xF000F000F000F000ULL) >> 12);
+}
+
+uint64_t Board::flip(uint64_t x) {
+    // 反转4个16位的行
+    return (x << 48) | ((x & 0xFFFF0000ULL) << 16) | ((x >> 16) & 0xFFFF0000ULL) | (x >> 48);
+}
+
+uint64_t Board::movePacked(uint64_t packed, Direction dir, int* scoreGain) {
+    // 上下移动先转置，列变成行，再按左右处理后转置回来
+    bool vertical = dir == Direction::UP || dir == Direction::DOWN;
+    bool toLow = dir == Direction::UP || dir == Direction::LEFT;
+    uint64_t board = vertical ? transpose(packed) : packed;
+    const uint16_t* table = toLow ? kRows.left : kRows.right;
+    
+    uint64_t result = 0;
+    int gain = 0;
+    for (int r = 0; r < 4; ++r) {
+        uint16_t row = static_cast<uint16_t>(board >> (16 * r));
+        result |= static_cast<uint64_t>(table[row]) << (16 * r);
+        gain += static_cast<int>(kRows.score[row]);
+    }
+    if (scoreGain) {
+        *scoreGain = gain;
+    }
+    return vertical ? transpose(result) : result;
+}
+
+int Board::emptyCount(uint64_t packed) {
+    // 把每个半字节折叠到最低位：非空格为1
+    uint64_t x = packed | (packed >> 1);
+    x |= x >> 2;
+    x &= 0x1111111111111111ULL;
+    return 16 - __builtin_popcountll(x);
+}
+
+uint64_t Board::spawnPacked(uint64_t packed, uint64_t& rngState) {
+    int empty = emptyCount(packed);
+    if (empty == 0) {
+        return packed;
+    }
+    uint64_t random = splitmix64(rngState);
+    int target = static_cast<int>(((random >> 32) * static_cast<uint64_t>(empty)) >> 32);
+    uint64_t tile = (random & 0xffffffffu) < 0x1999999au ? 2 : 1;
+    
+    // 空格掩码：每个空格在其半字节最低位为1；去掉前 target 个空格后最低的1就是目标格
+    uint64_t x = packed | (packed >> 1);
+    x |= x >> 2;
+    uint64_t empties = ~x & 0x1111111111111111ULL;
+    for (; target > 0; --target) {
+        empties &= empties - 1;
+    }
+    return packed | (tile << __builtin_ctzll(empties));
+}
+
+uint64_t Board::canonical(uint64_t packed) {
+    // 4种翻转组合 x 是否转置 = 8种对称
+    uint64_t m = mirror(packed);
+    uint64_t f = flip(packed);
+    uint64_t mf = flip(m);
+    uint64_t best = std::min(std::min(packed, m), std::min(f, mf));
+    uint64_t t = std::min(std::min(transpose(packed), transpose(m)), std::min(transpose(f), transpose(mf)));
+    return std::min(best, t);
+}
+
+uint64_t Board::nextRandom() {
+    return splitmix64(rngState_);
+}
+
 bool Board::hasWon() const {
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
@@ -91,7 +378,8 @@ bool Board::hasWon() const {
 
 bool Board::isGameOver() const {
     // 如果有空格，游戏未结束
-    if (!getEmptyCells().empty()) {
+    int cells[16];
+    if (getEmptyCells(cells) > 0) {
         return false;
     }
     
@@ -99,6 +387,16 @@ bool Board::isGameOver() const {
     return !canMove();
 }
 
+int Board::getMaxTile() const {
+    int maxTile = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            maxTile = std::max(maxTile, grid_[i][j]);
+        }
+    }
+    return maxTile;
+}
+
 int Board::getScore() const {
     return score_;
 }
@@ -275,18 +573,18 @@ bool Board::canMove() const {
     return false;
 }
 
-std::vector<std::pair<int, int>> Board::getEmptyCells() const {
-    std::vector<std::pair<int, int>> cells;
+int Board::getEmptyCells(int cells[16]) const {
+    int count = 0;
     
     for (int row = 0; row < 4; ++row) {
         for (int col = 0; col < 4; ++col) {
             if (grid_[row][col] == 0) {
-                cells.push_back({row, col});
+                cells[count++] = row * 4 + col;
             }
         }
     }
     
-    return cells;
+    return count;
 }
 
 void Board::copyGrid(const int src[4][4], int dst[4][4]) const {
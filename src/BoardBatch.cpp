@@ -0,0 +1,271 @@
+#include "BoardBatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BOARDBATCH_X86 1
+#endif
+
+namespace {
+
+// 每个方向的4条线，每条线按移动方向从前到后列出格子下标
+const int kLines[4][4][4] = {
+    {{0, 4, 8, 12}, {1, 5, 9, 13}, {2, 6, 10, 14}, {3, 7, 11, 15}},   // UP
+    {{12, 8, 4, 0}, {13, 9, 5, 1}, {14, 10, 6, 2}, {15, 11, 7, 3}},   // DOWN
+    {{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9, 10, 11}, {12, 13, 14, 15}},   // LEFT
+    {{3, 2, 1, 0}, {7, 6, 5, 4}, {11, 10, 9, 8}, {15, 14, 13, 12}},   // RIGHT
+};
+
+// 标量实现：逐个局面逐条线压紧、合并
+size_t moveScalar(uint8_t* cells, size_t stride, size_t count, Direction dir, uint32_t* gains, uint8_t* changed) {
+    const int (*lines)[4] = kLines[static_cast<int>(dir)];
+    size_t changedCount = 0;
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t gain = 0;
+        bool moved = false;
+        for (int l = 0; l < 4; ++l) {
+            uint8_t* line[4];
+            uint8_t in[4];
+            for (int j = 0; j < 4; ++j) {
+                line[j] = cells + lines[l][j] * stride + k;
+                in[j] = *line[j];
+            }
+            uint8_t out[4] = {0, 0, 0, 0};
+            int n = 0;
+            bool merged = false;
+            for (int j = 0; j < 4; ++j) {
+                if (in[j] == 0) continue;
+                if (n > 0 && !merged && out[n - 1] == in[j]) {
+                    ++out[n - 1];
+                    gain += 1u << out[n - 1];
+                    merged = true;
+                } else {
+                    out[n++] = in[j];
+                    merged = false;
+                }
+            }
+            for (int j = 0; j < 4; ++j) {
+                moved |= out[j] != in[j];
+                *line[j] = out[j];
+            }
+        }
+        gains[k] = gain;
+        changed[k] = moved ? 1 : 0;
+        changedCount += moved ? 1 : 0;
+    }
+    return changedCount;
+}
+
+#ifdef BOARDBATCH_X86
+
+// 向量实现的步骤（每个通道一个局面，一条线的4格各占一个寄存器）：
+//   1. 压紧：三轮冒泡，前一格为空就把后一格挪过来
+//   2. 合并：依次检查 (0,1)、(1,2)、(2,3)，相等且非空则前一格加一、其后的格子前移
+//   3. 得分：合并后的值扩展为32位通道，累加 2^值
+// 比较结果是全1/全0的掩码，用 blendv 代替分支
+
+// 得分累加：v 为合并后的值（未合并的通道为0），sum += v > 0 ? 2^v : 0
+// SSE 没有按通道的移位，把 v+127 放进 float 的指数位再转回整数
+__attribute__((target("sse4.1")))
+inline __m128i addPowersSse41(__m128i sum, __m128i v) {
+    __m128i power = _mm_cvtps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(v, _mm_set1_epi32(127)), 23)));
+    return _mm_add_epi32(sum, _mm_and_si128(power, _mm_cmpgt_epi32(v, _mm_setzero_si128())));
+}
+
+__attribute__((target("avx2")))
+inline __m256i addPowersAvx2(__m256i sum, __m256i v) {
+    __m256i power = _mm256_sllv_epi32(_mm256_set1_epi32(1), v);
+    return _mm256_add_epi32(sum, _mm256_and_si256(power, _mm256_cmpgt_epi32(v, _mm256_setzero_si256())));
+}
+
+__attribute__((target("sse4.1")))
+size_t moveSse41(uint8_t* cells, size_t stride, size_t count, Direction dir, uint32_t* gains, uint8_t* changed) {
+    const int (*lines)[4] = kLines[static_cast<int>(dir)];
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    size_t changedCount = 0;
+    
+    for (size_t k = 0; k < count; k += 16) {
+        __m128i gain[4] = {zero, zero, zero, zero};
+        __m128i moved = zero;
+        for (int l = 0; l < 4; ++l) {
+            uint8_t* p[4];
+            __m128i x[4], in[4];
+            for (int j = 0; j < 4; ++j) {
+                p[j] = cells + lines[l][j] * stride + k;
+                in[j] = x[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p[j]));
+            }
+            for (int pass = 0; pass < 3; ++pass) {
+                for (int j = 0; j < 3; ++j) {
+                    __m128i empty = _mm_cmpeq_epi8(x[j], zero);
+                    x[j] = _mm_blendv_epi8(x[j], x[j + 1], empty);
+                    x[j + 1] = _mm_andnot_si128(empty, x[j + 1]);
+                }
+            }
+            for (int j = 0; j < 3; ++j) {
+                __m128i merge = _mm_andnot_si128(_mm_cmpeq_epi8(x[j], zero), _mm_cmpeq_epi8(x[j], x[j + 1]));
+                x[j] = _mm_sub_epi8(x[j], merge);  // 掩码为 -1，减去即加一
+                for (int m = j + 1; m < 3; ++m) {
+                    x[m] = _mm_blendv_epi8(x[m], x[m + 1], merge);
+                }
+                x[3] = _mm_andnot_si128(merge, x[3]);
+                
+                __m128i value = _mm_and_si128(x[j], merge);
+                gain[0] = addPowersSse41(gain[0], _mm_cvtepu8_epi32(value));
+                gain[1] = addPowersSse41(gain[1], _mm_cvtepu8_epi32(_mm_srli_si128(value, 4)));
+                gain[2] = addPowersSse41(gain[2], _mm_cvtepu8_epi32(_mm_srli_si128(value, 8)));
+                gain[3] = addPowersSse41(gain[3], _mm_cvtepu8_epi32(_mm_srli_si128(value, 12)));
+            }
+            for (int j = 0; j < 4; ++j) {
+                moved = _mm_or_si128(moved, _mm_xor_si128(x[j], in[j]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p[j]), x[j]);
+            }
+        }
+        for (int q = 0; q < 4; ++q) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gains + k + 4 * q), gain[q]);
+        }
+        unsigned unchangedMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(moved, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(changed + k), _mm_andnot_si128(_mm_cmpeq_epi8(moved, zero), one));
+        changedCount += static_cast<size_t>(16 - __builtin_popcount(unchangedMask));
+    }
+    return changedCount;
+}
+
+__attribute__((target("avx2")))
+size_t moveAvx2(uint8_t* cells, size_t stride, size_t count, Direction dir, uint32_t* gains, uint8_t* changed) {
+    const int (*lines)[4] = kLines[static_cast<int>(dir)];
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    size_t changedCount = 0;
+    
+    for (size_t k = 0; k < count; k += 32) {
+        __m256i gain[4] = {zero, zero, zero, zero};
+        __m256i moved = zero;
+        for (int l = 0; l < 4; ++l) {
+            uint8_t* p[4];
+            __m256i x[4], in[4];
+            for (int j = 0; j < 4; ++j) {
+                p[j] = cells + lines[l][j] * stride + k;
+                in[j] = x[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p[j]));
+            }
+            for (int pass = 0; pass < 3; ++pass) {
+                for (int j = 0; j < 3; ++j) {
+                    __m256i empty = _mm256_cmpeq_epi8(x[j], zero);
+                    x[j] = _mm256_blendv_epi8(x[j], x[j + 1], empty);
+                    x[j + 1] = _mm256_andnot_si256(empty, x[j + 1]);
+                }
+            }
+            for (int j = 0; j < 3; ++j) {
+                __m256i merge = _mm256_andnot_si256(_mm256_cmpeq_epi8(x[j], zero), _mm256_cmpeq_epi8(x[j], x[j + 1]));
+                x[j] = _mm256_sub_epi8(x[j], merge);
+                for (int m = j + 1; m < 3; ++m) {
+                    x[m] = _mm256_blendv_epi8(x[m], x[m + 1], merge);
+                }
+                x[3] = _mm256_andnot_si256(merge, x[3]);
+                
+                __m256i value = _mm256_and_si256(x[j], merge);
+                __m128i low = _mm256_castsi256_si128(value);
+                __m128i high = _mm256_extracti128_si256(value, 1);
+                gain[0] = addPowersAvx2(gain[0], _mm256_cvtepu8_epi32(low));
+                gain[1] = addPowersAvx2(gain[1], _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+                gain[2] = addPowersAvx2(gain[2], _mm256_cvtepu8_epi32(high));
+                gain[3] = addPowersAvx2(gain[3], _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+            }
+            for (int j = 0; j < 4; ++j) {
+                moved = _mm256_or_si256(moved, _mm256_xor_si256(x[j], in[j]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p[j]), x[j]);
+            }
+        }
+        for (int q = 0; q < 4; ++q) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gains + k + 8 * q), gain[q]);
+        }
+        unsigned unchangedMask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(moved, zero)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(changed + k),
+                            _mm256_andnot_si256(_mm256_cmpeq_epi8(moved, zero), one));
+        changedCount += static_cast<size_t>(32 - __builtin_popcount(unchangedMask));
+    }
+    return changedCount;
+}
+
+#endif // BOARDBATCH_X86
+
+} // namespace
+
+BoardBatch::BoardBatch(size_t count) : size_(0), stride_(0) {
+    resize(count);
+}
+
+void BoardBatch::resize(size_t count) {
+    size_ = count;
+    stride_ = (count + LANE_ALIGN - 1) / LANE_ALIGN * LANE_ALIGN;
+    cells_.assign(16 * stride_, 0);
+    gains_.assign(stride_, 0);
+    changed_.assign(stride_, 0);
+}
+
+void BoardBatch::set(size_t index, uint64_t packed) {
+    for (int i = 0; i < 16; ++i, packed >>= 4) {
+        cells_[i * stride_ + index] = static_cast<uint8_t>(packed & 0xf);
+    }
+}
+
+uint64_t BoardBatch::get(size_t index) const {
+    uint64_t packed = 0;
+    for (int i = 0; i < 16; ++i) {
+        packed |= static_cast<uint64_t>(cells_[i * stride_ + index] & 0xf) << (4 * i);
+    }
+    return packed;
+}
+
+size_t BoardBatch::move(Direction dir) {
+    static const BatchKernel kernel = bestKernel();
+    return move(dir, kernel);
+}
+
+size_t BoardBatch::move(Direction dir, BatchKernel kernel) {
+    // 补齐的空盘不会变化，计数时不受影响
+#ifdef BOARDBATCH_X86
+    if (kernel == BatchKernel::AVX2 && isSupported(kernel)) {
+        return moveAvx2(cells_.data(), stride_, stride_, dir, gains_.data(), changed_.data());
+    }
+    if (kernel == BatchKernel::SSE41 && isSupported(kernel)) {
+        return moveSse41(cells_.data(), stride_, stride_, dir, gains_.data(), changed_.data());
+    }
+#endif
+    return moveScalar(cells_.data(), stride_, size_, dir, gains_.data(), changed_.data());
+}
+
+BatchKernel BoardBatch::bestKernel() {
+    if (isSupported(BatchKernel::AVX2)) {
+        return BatchKernel::AVX2;
+    }
+    if (isSupported(BatchKernel::SSE41)) {
+        return BatchKernel::SSE41;
+    }
+    return BatchKernel::SCALAR;
+}
+
+bool BoardBatch::isSupported(BatchKernel kernel) {
+    switch (kernel) {
+        case BatchKernel::SCALAR:
+            return true;
+#ifdef BOARDBATCH_X86
+        case BatchKernel::SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case BatchKernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* BoardBatch::kernelName(BatchKernel kernel) {
+    switch (kernel) {
+        case BatchKernel::SSE41:
+            return "sse4.1";
+        case BatchKernel::AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,206 @@
+#include "EvilSpawner.h"
+#include <algorithm>
+
+namespace {
+
+const int kLoss = -1000000;      // 玩家无法移动
+const int kInfinity = 1 << 30;
+
+// 静态估值（玩家视角，越大对玩家越有利）：空格数为主，相邻可合并的对数为辅
+int evaluate(uint64_t board) {
+    int empty = Board::emptyCount(board);
+    int pairs = 0;
+    for (int i = 0; i < 16; ++i) {
+        uint64_t value = (board >> (4 * i)) & 0xf;
+        if (value == 0) continue;
+        if (i % 4 < 3 && ((board >> (4 * (i + 1))) & 0xf) == value) ++pairs;
+        if (i < 12 && ((board >> (4 * (i + 4))) & 0xf) == value) ++pairs;
+    }
+    return empty * 4 + pairs;
+}
+
+// 一次搜索的上下文：截止时间和取消标志每1024个节点检查一次，超时后整层作废
+struct Search {
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* cancelled;
+    uint64_t nodes;
+    bool aborted;
+    
+    Search() : hasDeadline(false), cancelled(nullptr), nodes(0), aborted(false) {}
+    
+    bool checkAbort() {
+        if ((++nodes & 1023) == 0) {
+            if ((cancelled && cancelled->load(std::memory_order_relaxed)) ||
+                (hasDeadline && std::chrono::steady_clock::now() >= deadline)) {
+                aborted = true;
+            }
+        }
+        return aborted;
+    }
+    
+    // 玩家走子：取四个方向中最大的
+    int player(uint64_t board, int depth, int alpha, int beta) {
+        if (checkAbort()) return 0;
+        bool canMove = false;
+        int best = kLoss;
+        for (int d = 0; d < 4; ++d) {
+            uint64_t after = Board::movePacked(board, static_cast<Direction>(d));
+            if (after == board) continue;
+            if (depth == 0) {
+                return evaluate(board);
+            }
+            canMove = true;
+            best = std::max(best, spawner(after, depth, alpha, beta));
+            alpha = std::max(alpha, best);
+            if (alpha >= beta) break;
+        }
+        return canMove ? best : kLoss;
+    }
+    
+    // 生成方：所有空格 x {2, 4} 中取最小的
+    int spawner(uint64_t after, int depth, int alpha, int beta) {
+        int best = kInfinity;
+        for (int i = 0; i < 16; ++i) {
+            if (((after >> (4 * i)) & 0xf) != 0) continue;
+            for (uint64_t tile = 1; tile <= 2; ++tile) {
+                best = std::min(best, player(after | (tile << (4 * i)), depth - 1, alpha, beta));
+                beta = std::min(beta, best);
+                if (alpha >= beta || aborted) return best;
+            }
+        }
+        return best;
+    }
+    
+    // 根节点：返回最小值对应的选择；上一层的最佳选择先搜，剪枝更多
+    bool root(uint64_t after, int depth, SpawnChoice& choice) {
+        int candidates[32];
+        int count = 0;
+        for (int i = 0; i < 16; ++i) {
+            if (((after >> (4 * i)) & 0xf) != 0) continue;
+            for (int tile = 1; tile <= 2; ++tile) {
+                candidates[count++] = i * 4 + tile;
+            }
+        }
+        if (count == 0) return false;
+        if (choice.depth > 0) {
+            for (int c = 1; c < count; ++c) {
+                if (candidates[c] == choice.cell * 4 + (choice.value == 4 ? 2 : 1)) {
+                    std::swap(candidates[0], candidates[c]);
+                }
+            }
+        }
+        
+        int best = kInfinity;
+        int bestCandidate = candidates[0];
+        for (int c = 0; c < count; ++c) {
+            int cell = candidates[c] / 4;
+            uint64_t tile = static_cast<uint64_t>(candidates[c] % 4);
+            int value = player(after | (tile << (4 * cell)), depth - 1, kLoss - 1, best);
+            if (aborted) return false;
+            if (value < best) {
+                best = value;
+                bestCandidate = candidates[c];
+            }
+        }
+        choice.cell = bestCandidate / 4;
+        choice.value = bestCandidate % 4 == 2 ? 4 : 2;
+        choice.depth = depth;
+        return true;
+    }
+};
+
+} // namespace
+
+EvilSpawner::EvilSpawner(JobSystem& jobs)
+    : budgetMs_(DEFAULT_BUDGET_MS),
+      requestGeneration_(0),
+      resultBoard_(0),
+      hasResult_(false),
+      result_(),
+      cancelled_(false),
+      strand_(jobs, JobPriority::HIGH) {
+}
+
+EvilSpawner::~EvilSpawner() {
+    // 正在进行的搜索尽快结束；strand_ 析构时等它返回
+    cancel();
+}
+
+void EvilSpawner::setTimeBudget(int milliseconds) {
+    budgetMs_ = milliseconds < 1 ? 1 : milliseconds;
+}
+
+void EvilSpawner::request(uint64_t afterstate) {
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation = ++requestGeneration_;
+        hasResult_ = false;
+        cancelled_ = true;  // 旧局面的搜索尽快结束
+    }
+    strand_.submit([this, afterstate, generation]() { runSearch(afterstate, generation); });
+}
+
+bool EvilSpawner::take(uint64_t afterstate, SpawnChoice& choice) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++requestGeneration_;
+        cancelled_ = true;
+        if (hasResult_ && resultBoard_ == afterstate) {
+            choice = result_;
+            hasResult_ = false;
+            return true;
+        }
+    }
+    // 后台还没完成任何一层（或没有提交过）：当场搜一层
+    return search(afterstate, 1, choice);
+}
+
+void EvilSpawner::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++requestGeneration_;
+    hasResult_ = false;
+    cancelled_ = true;
+}
+
+bool EvilSpawner::search(uint64_t afterstate, int depth, SpawnChoice& choice) {
+    Search search;
+    choice = SpawnChoice();
+    for (int d = 1; d <= depth; ++d) {
+        if (!search.root(afterstate, d, choice)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EvilSpawner::runSearch(uint64_t board, uint32_t generation) {
+    {
+        // 排队期间已被新请求取代、取走或取消：不必开始
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != requestGeneration_) {
+            return;
+        }
+        cancelled_ = false;  // 串行队列中前一个搜索已经结束，标记只属于本次
+    }
+    
+    // 迭代加深：每完成一层发布一次结果
+    Search search;
+    search.hasDeadline = true;
+    search.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs_.load());
+    search.cancelled = &cancelled_;
+    SpawnChoice choice = SpawnChoice();
+    for (int depth = 1; depth <= MAX_DEPTH; ++depth) {
+        if (!search.root(board, depth, choice)) {
+            break;
+        }
+        std::lock_guard<std::mutex> publish(mutex_);
+        if (generation != requestGeneration_ || cancelled_) {
+            break;
+        }
+        resultBoard_ = board;
+        result_ = choice;
+        hasResult_ = true;
+    }
+}
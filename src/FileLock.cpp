@@ -0,0 +1,17 @@
+#include "FileLock.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+FileLock::FileLock(const std::string& path, bool exclusive) : fd_(::open(path.c_str(), O_RDWR | O_CREAT, 0644)) {
+    if (fd_ >= 0) {
+        flock(fd_, exclusive ? LOCK_EX : LOCK_SH);
+    }
+}
+
+FileLock::~FileLock() {
+    if (fd_ >= 0) {
+        flock(fd_, LOCK_UN);
+        ::close(fd_);
+    }
+}
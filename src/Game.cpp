@@ -1,15 +1,52 @@
 #include "Game.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <iomanip>
+#include <sys/stat.h>
+
+namespace {
+
+// 回放倍速档位，以及窗口帧率（每秒步数超过帧率时不做插值）
+const float kReplaySpeeds[] = {1, 2, 5, 10, 25, 50, 100, 250, 500, 1000};
+const size_t kReplaySpeedCount = sizeof(kReplaySpeeds) / sizeof(kReplaySpeeds[0]);
+const float kDisplayRate = 60.0f;
+
+} // namespace
 
 Game::Game() 
     : window_(sf::VideoMode(600, 800), "2048 Game"),
       renderer_(window_),
+      io_(jobs_, JobPriority::LOW),
+      nameIndexBuilding_(false),
+      nameIndexFailedVersion_(0),
       state_(GameState::MENU),
       wonDisplayed_(false),
-      menuSelection_(0) {
+      moveCount_(0),
+      replaySpeedIndex_(0),
+      replayPaused_(false),
+      replayAccumulator_(0.0f),
+      ai_(jobs_),
+      autoplay_(false),
+      autoplayPolicy_(AutoplayPolicy::MONTE_CARLO_RANDOM),
+      evilSpawner_(jobs_),
+      hardMode_(false),
+      hardModeUsed_(false),
+      hintSearch_(jobs_),
+      hintEnabled_(false),
+      hintRequested_(false),
+      hintBoard_(0),
+      hintGeneration_(0),
+      showJobStats_(false),
+      menuSelection_(0),
+      stopping_(false),
+      quitRequested_(false) {
     
-    window_.setFramerateLimit(60);
+    window_.setFramerateLimit(static_cast<unsigned>(kDisplayRate));
     
     // 初始化渲染器
     if (!renderer_.init()) {
@@ -27,114 +64,457 @@ Game::Game()
     // 加载排行榜
     rankList_.load();
     
+    // 映射玩家统计文件
+    if (!playerStats_.open()) {
+        std::cerr << "警告: 无法打开玩家统计文件" << std::endl;
+    }
+    
+    // 映射训练好的n元组网络权重（没有则只能用蒙特卡洛策略）
+    evaluator_.open("ntuple.bin");
+    hintSearch_.setEvaluator(evaluator_.isReady() ? &evaluator_ : nullptr);
+    
+    // 开局库只记下路径，不在启动时读文件
+    openingBook_.open("opening.bin");
+    hintSearch_.setBook(&openingBook_);
+    
     // 初始化菜单
-    menu_.setHasSaveFile(saveManager_.hasSave());
+    menu_.setHasSaveFile(hasSave());
 }
 
 Game::~Game() {
+    stopping_.store(true);
+    if (logicThread_.joinable()) {
+        logicThread_.join();
+    }
 }
 
 void Game::run() {
+    // 逻辑线程启动前先在本线程跑一拍，第一帧就有快照可画
+    updateLogic();
+    logicThread_ = std::thread(&Game::logicLoop, this);
+    
     while (window_.isOpen()) {
         sf::Event event;
         while (window_.pollEvent(event)) {
             if (event.type == sf::Event::Closed) {
                 window_.close();
+            } else if (event.type == sf::Event::TextEntered || event.type == sf::Event::KeyPressed ||
+                       event.type == sf::Event::MouseMoved || event.type == sf::Event::MouseButtonPressed ||
+                       event.type == sf::Event::MouseWheelScrolled) {
+                input_.push(event);  // 队列满（逻辑线程卡住）时丢弃，不阻塞绘制
             }
-            
-            // 处理文本输入（菜单状态）
-            if (event.type == sf::Event::TextEntered && state_ == GameState::MENU) {
-                menu_.handleTextInput(event.text.unicode);
+        }
+        if (quitRequested_.load(std::memory_order_relaxed)) {
+            window_.close();
+        }
+        
+        // 画逻辑线程最新发布的一帧；逻辑线程在存档或计算时，继续画上一帧
+        renderer_.renderFrame(frames_.read());
+    }
+    
+    stopping_.store(true);
+    logicThread_.join();
+}
+
+void Game::logicLoop() {
+    // 固定节拍：落后时（如写文件、同步策略计算耗时）不追赶，从当前时刻重新计时
+    const auto period = std::chrono::microseconds(static_cast<int64_t>(1000000 / kDisplayRate));
+    auto next = std::chrono::steady_clock::now();
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        updateLogic();
+        next += period;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Game::updateLogic() {
+    sf::Event event;
+    while (input_.pop(event)) {
+        handleEvent(event);
+    }
+    
+    // 定期检查其他实例是否更新了共享排行榜（只做stat，开销很小）
+    if (rankWatchClock_.getElapsedTime().asSeconds() >= 1.0f) {
+        rankWatchClock_.restart();
+        rankList_.refreshIfChanged();
+    }
+    
+    // 后台任务完成后登记的回调在逻辑线程执行
+    jobs_.runCompletions();
+    
+    // 更新动画
+    float deltaTime = clock_.restart().asSeconds();
+    animator_.update(deltaTime);
+    
+    if (autoplay_) {
+        updateAutoplay();
+    }
+    if (hintEnabled_) {
+        updateHint();
+    }
+    
+    // 状态机处理：各状态把本帧要画的内容写入快照
+    switch (state_) {
+        case GameState::MENU:
+            handleMenuState();
+            break;
+        case GameState::PLAYING:
+            handlePlayingState();
+            break;
+        case GameState::WON:
+            handleWonState();
+            break;
+        case GameState::GAME_OVER:
+            handleGameOverState();
+            break;
+        case GameState::RANK_LIST:
+            handleRankListState();
+            break;
+        case GameState::REPLAY:
+            handleReplayState(deltaTime);
+            break;
+    }
+    frames_.publish();
+}
+
+void Game::handleEvent(const sf::Event& event) {
+    // 处理文本输入（菜单状态）
+    if (event.type == sf::Event::TextEntered && state_ == GameState::MENU) {
+        menu_.handleTextInput(event.text.unicode);
+    }
+    
+    // 处理鼠标移动（菜单和排行榜状态）
+    if (event.type == sf::Event::MouseMoved) {
+        if (state_ == GameState::MENU || state_ == GameState::RANK_LIST) {
+            menu_.updateHover(event.mouseMove.x, event.mouseMove.y);
+        }
+    }
+    
+    // 处理鼠标滚轮（排行榜滚动）
+    if (event.type == sf::Event::MouseWheelScrolled && state_ == GameState::RANK_LIST &&
+        event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+        int rows = event.mouseWheelScroll.delta > 0 ? -1 : 1;
+        menu_.scrollRankList(rows, rankList_.size());
+    }
+    
+    // 处理鼠标点击
+    if (event.type == sf::Event::MouseButtonPressed && 
+        event.mouseButton.button == sf::Mouse::Left) {
+        if (state_ == GameState::MENU) {
+            // 点击补全建议：填入名字，不再触发被遮住的按钮
+            if (menu_.handleSuggestionClick(event.mouseButton.x, event.mouseButton.y)) {
+                return;
             }
             
-            // 处理鼠标移动（菜单和排行榜状态）
-            if (event.type == sf::Event::MouseMoved) {
-                if (state_ == GameState::MENU || state_ == GameState::RANK_LIST) {
-                    menu_.updateHover(event.mouseMove.x, event.mouseMove.y);
-                }
-            }
+            // 检查输入框点击
+            menu_.checkInputBoxClick(event.mouseButton.x, event.mouseButton.y);
             
-            // 处理鼠标点击
-            if (event.type == sf::Event::MouseButtonPressed && 
-                event.mouseButton.button == sf::Mouse::Left) {
-                if (state_ == GameState::MENU) {
-                    // 检查输入框点击
-                    menu_.checkInputBoxClick(event.mouseButton.x, event.mouseButton.y);
-                    
-                    // 检查按钮点击
-                    MenuAction action = menu_.handleClick(event.mouseButton.x, event.mouseButton.y);
-                    
-                    if (action == MenuAction::CONTINUE_GAME) {
-                        continueGame();
-                    } else if (action == MenuAction::START_GAME || action == MenuAction::NEW_GAME) {
-                        username_ = menu_.getPlayerName();
-                        startNewGame();
-                    } else if (action == MenuAction::VIEW_RANK) {
-                        state_ = GameState::RANK_LIST;
-                    } else if (action == MenuAction::QUIT) {
-                        window_.close();
-                    }
-                } else if (state_ == GameState::RANK_LIST) {
-                    MenuAction action = menu_.handleClick(event.mouseButton.x, event.mouseButton.y);
-                    if (action == MenuAction::BACK_TO_MENU) {
-                        state_ = GameState::MENU;
-                        menu_.setHasSaveFile(saveManager_.hasSave());
-                    }
-                }
-            }
+            // 检查按钮点击
+            MenuAction action = menu_.handleClick(event.mouseButton.x, event.mouseButton.y);
             
-            if (event.type == sf::Event::KeyPressed) {
-                processInput();
+            if (action == MenuAction::CONTINUE_GAME) {
+                continueGame();
+            } else if (action == MenuAction::START_GAME || action == MenuAction::NEW_GAME) {
+                username_ = menu_.getPlayerName();
+                startNewGame();
+            } else if (action == MenuAction::VIEW_RANK) {
+                menu_.resetRankScroll();
+                state_ = GameState::RANK_LIST;
+            } else if (action == MenuAction::QUIT) {
+                quitRequested_.store(true);
+            }
+        } else if (state_ == GameState::RANK_LIST) {
+            MenuAction action = menu_.handleClick(event.mouseButton.x, event.mouseButton.y);
+            if (action == MenuAction::BACK_TO_MENU) {
+                state_ = GameState::MENU;
+                menu_.setHasSaveFile(hasSave());
             }
-        }
-        
-        // 更新动画
-        float deltaTime = clock_.restart().asSeconds();
-        animator_.update(deltaTime);
-        
-        // 状态机处理
-        switch (state_) {
-            case GameState::MENU:
-                handleMenuState();
-                break;
-            case GameState::PLAYING:
-                handlePlayingState();
-                break;
-            case GameState::WON:
-                handleWonState();
-                break;
-            case GameState::GAME_OVER:
-                handleGameOverState();
-                break;
-            case GameState::RANK_LIST:
-                handleRankListState();
-                break;
         }
     }
+    
+    if (event.type == sf::Event::KeyPressed) {
+        processInput(event.key.code);
+    }
+}
+
+void Game::fillBoardFrame(const Board& board, const std::string& username, int bestScore,
+                          const std::string& statusText, const std::string& detailText, const Hint* hint) {
+    FrameSnapshot& frame = frames_.writeBuffer();
+    frame.screen = FrameScreen::BOARD;
+    frame.board = board;
+    frame.tiles = animator_.getVisualTiles();
+    frame.username = username;
+    frame.bestScore = bestScore;
+    frame.statusText = statusText;
+    frame.detailText = detailText;
+    frame.hasHint = hint != nullptr;
+    if (hint) {
+        frame.hint = *hint;
+    }
 }
 
 void Game::handleMenuState() {
-    renderer_.renderMenu(menu_);
+    // 排行榜发布新版本后在后台重建名字前缀索引（百万个名字约0.2秒，不能卡住逻辑线程），建好后在这里换入
+    std::shared_ptr<const RankSnapshot> snapshot = rankList_.snapshot();
+    uint64_t version = snapshot->version();
+    if (!nameIndexBuilding_ && version != menu_.getNameIndexVersion() && version != nameIndexFailedVersion_) {
+        nameIndexBuilding_ = true;
+        jobs_.submit(JobPriority::LOW, [snapshot]() {
+            auto index = std::make_shared<PrefixIndex>();
+            index->build(snapshot);
+            return std::shared_ptr<const PrefixIndex>(std::move(index));
+        }).then([this](const std::shared_ptr<const PrefixIndex>& index) {
+            nameIndexBuilding_ = false;  // 构建期间又有新版本时，下一帧再建一次
+            menu_.setNameIndex(index);
+        }, [this, version](std::exception_ptr) {
+            // 构建失败（如内存不足）：保留旧索引，同一版本不再重试，排行榜有新版本时再建
+            nameIndexBuilding_ = false;
+            nameIndexFailedVersion_ = version;
+        });
+    }
+    
+    FrameSnapshot& frame = frames_.writeBuffer();
+    frame.screen = FrameScreen::MENU;
+    menu_.fillView(frame.menu);
 }
 
 void Game::handleRankListState() {
-    renderer_.renderRankList(rankList_, menu_);
+    FrameSnapshot& frame = frames_.writeBuffer();
+    frame.screen = FrameScreen::RANK_LIST;
+    frame.ranks = rankList_.snapshot();
+    menu_.fillView(frame.menu);
+}
+
+void Game::handleReplayState(float deltaTime) {
+    // 按倍速累计应播放的步数：能插值时一步一动画，超过帧率时直接跳到目标步
+    if (!replayPaused_ && !replayPlayer_.atEnd()) {
+        float rate = kReplaySpeeds[replaySpeedIndex_] * animator_.baseMovesPerSecond();
+        replayAccumulator_ += deltaTime * rate;
+        
+        if (animator_.isSkippingInterpolation()) {
+            size_t steps = static_cast<size_t>(replayAccumulator_);
+            replayAccumulator_ -= static_cast<float>(steps);
+            replayPlayer_.seek(replayPlayer_.position() + steps);
+        } else if (!animator_.isAnimating() && replayAccumulator_ >= 1.0f) {
+            replayAccumulator_ = std::min(replayAccumulator_ - 1.0f, 1.0f);
+            stepReplayAnimated();
+        }
+    }
+    
+    std::string status = "Replay " + std::to_string(static_cast<int>(kReplaySpeeds[replaySpeedIndex_])) + "x  "
+                       + std::to_string(replayPlayer_.position()) + "/" + std::to_string(replayPlayer_.length());
+    if (replayPaused_) {
+        status += "  (paused)";
+    }
+    
+    fillBoardFrame(
+        replayPlayer_.board(),
+        replayPlayer_.replay().username(),
+        replayPlayer_.replay().finalScore(),
+        status,
+        "Space pause  Up/Down speed  Left/Right step  PgUp/PgDn jump  Esc back"
+    );
+}
+
+void Game::startReplay(const Replay& replay) {
+    if (!replayPlayer_.load(replay)) {
+        std::cerr << "警告: 回放文件损坏" << std::endl;
+        return;
+    }
+    
+    replayPaused_ = false;
+    replayAccumulator_ = 0.0f;
+    animator_.stop();
+    setReplaySpeed(0);
+    state_ = GameState::REPLAY;
+}
+
+void Game::stepReplayAnimated() {
+    if (replayPlayer_.atEnd()) {
+        return;
+    }
+    
+    int gridBefore[4][4];
+    replayPlayer_.board().getGrid(gridBefore);
+    Direction dir = replayPlayer_.nextMove();
+    MoveResult result = replayPlayer_.board().simulateMove(dir);
+    replayPlayer_.step();
+    
+    // 新方块位置：移动后的网格与前进后的局面唯一不同的格子
+    int row = -1, col = -1, value = 0;
+    for (int i = 0; i < 16; ++i) {
+        int current = replayPlayer_.board().getValue(i / 4, i % 4);
+        if (current != result.grid[i / 4][i % 4]) {
+            row = i / 4;
+            col = i % 4;
+            value = current;
+        }
+    }
+    
+    animator_.startMoveAnimation(computeMoveEvents(gridBefore, result.grid, dir), gridBefore);
+    animator_.setOnComplete([this, row, col, value]() {
+        animator_.setOnComplete(nullptr);
+        if (row >= 0) {
+            animator_.startSpawnAnimation(row, col, value);
+        }
+    });
+}
+
+void Game::seekReplay(size_t move) {
+    animator_.stop();
+    replayAccumulator_ = 0.0f;
+    replayPlayer_.seek(move);
+}
+
+void Game::setReplaySpeed(size_t speedIndex) {
+    replaySpeedIndex_ = std::min(speedIndex, kReplaySpeedCount - 1);
+    animator_.setPlaybackRate(kReplaySpeeds[replaySpeedIndex_] * animator_.baseMovesPerSecond(), kDisplayRate);
 }
 
 void Game::handlePlayingState() {
-    renderer_.render(
+    // 提示只在局面静止时显示（槽位读取无锁，每帧取最新一层的结果）
+    Hint hint;
+    bool showHint = hintEnabled_ && hintRequested_ && !animator_.isAnimating() &&
+                    hintSearch_.current(hintGeneration_, hint);
+    fillBoardFrame(
         board_,
-        animator_.getVisualTiles(),
         username_,
         rankList_.getBestScore(),
-        ""
+        "",
+        showJobStats_ ? jobStatsText()
+                      : autoplay_ ? autoplayStatus()
+                                  : (hardMode_ ? "Hard mode: evil spawner  (H to turn off)" : ""),
+        showHint ? &hint : nullptr
     );
 }
 
+void Game::updateAutoplay() {
+    // 自动走子时不停在胜利提示
+    if (state_ == GameState::WON) {
+        state_ = GameState::PLAYING;
+    }
+    if (state_ != GameState::PLAYING || animator_.isAnimating()) {
+        return;
+    }
+    
+    uint64_t packed;
+    if (!board_.pack(packed)) {
+        setAutoplay(false);  // 超过32768的方块无法用紧凑表示
+        return;
+    }
+    
+    // 前几步先查开局库，命中就不用搜索
+    BookMove bookMove;
+    if (openingBook_.lookup(packed, bookMove)) {
+        handleMove(bookMove.dir);
+        return;
+    }
+    
+    Direction dir;
+    if (autoplayStrategy_) {
+        if (autoplayStrategy_.choose(packed, dir)) {
+            handleMove(dir);
+        }
+    } else if (ai_.poll(packed, dir)) {
+        handleMove(dir);
+    } else if (!ai_.isBusy()) {
+        ai_.request(packed);  // 局面变化后（包括手动移动、撤销）重新提交
+    }
+}
+
+void Game::updateHint() {
+    if (state_ != GameState::PLAYING || animator_.isAnimating()) {
+        return;
+    }
+    uint64_t packed;
+    if (!board_.pack(packed)) {
+        return;  // 超过32768的方块无法用紧凑表示
+    }
+    if (!hintRequested_ || packed != hintBoard_) {
+        hintGeneration_ = hintSearch_.request(packed);
+        hintBoard_ = packed;
+        hintRequested_ = true;
+    }
+}
+
+void Game::cancelHint() {
+    if (hintRequested_) {
+        hintSearch_.cancel();
+        hintRequested_ = false;
+    }
+}
+
+void Game::setAutoplay(bool enabled) {
+    autoplay_ = enabled;
+    if (!enabled) {
+        ai_.cancel();
+    }
+}
+
+void Game::cycleAutoplayPolicy() {
+    switch (autoplayPolicy_) {
+        case AutoplayPolicy::MONTE_CARLO_RANDOM:
+            autoplayPolicy_ = AutoplayPolicy::MONTE_CARLO_GREEDY;
+            break;
+        case AutoplayPolicy::MONTE_CARLO_GREEDY:
+            autoplayPolicy_ = evaluator_.isReady() ? AutoplayPolicy::NTUPLE : AutoplayPolicy::SEARCH;
+            break;
+        case AutoplayPolicy::NTUPLE:
+            autoplayPolicy_ = AutoplayPolicy::SEARCH;
+            break;
+        case AutoplayPolicy::SEARCH:
+            autoplayPolicy_ = AutoplayPolicy::GREEDY;
+            break;
+        case AutoplayPolicy::GREEDY:
+            autoplayPolicy_ = AutoplayPolicy::CORNER;
+            break;
+        case AutoplayPolicy::CORNER:
+            autoplayPolicy_ = AutoplayPolicy::MONTE_CARLO_RANDOM;
+            break;
+    }
+    
+    // 蒙特卡洛在后台线程决策，其余策略通过统一的策略接口当场计算
+    const NTupleNetwork* network = evaluator_.isReady() ? &evaluator_ : nullptr;
+    switch (autoplayPolicy_) {
+        case AutoplayPolicy::NTUPLE:
+            autoplayStrategy_ = NTuplePolicy(evaluator_);
+            break;
+        case AutoplayPolicy::SEARCH:
+            autoplayStrategy_ = SearchPolicy(2, network);
+            break;
+        case AutoplayPolicy::GREEDY:
+            autoplayStrategy_ = GreedyPolicy();
+            break;
+        case AutoplayPolicy::CORNER:
+            autoplayStrategy_ = CornerPolicy();
+            break;
+        default:
+            autoplayStrategy_ = AnyPolicy();
+            break;
+    }
+    ai_.setPlayoutPolicy(autoplayPolicy_ == AutoplayPolicy::MONTE_CARLO_GREEDY ? PlayoutPolicy::GREEDY
+                                                                                : PlayoutPolicy::RANDOM);
+    ai_.cancel();  // 旧策略的决策作废
+}
+
+std::string Game::autoplayStatus() const {
+    std::string status = "Auto: ";
+    if (autoplayStrategy_) {
+        status += autoplayStrategy_.name();
+    } else {
+        status += autoplayPolicy_ == AutoplayPolicy::MONTE_CARLO_GREEDY ? "MC greedy " : "MC random ";
+        status += std::to_string(ai_.lastStats().playouts) + " playouts";
+    }
+    return status + "  |  A stop  P policy";
+}
+
 void Game::handleWonState() {
-    renderer_.render(
+    fillBoardFrame(
         board_,
-        animator_.getVisualTiles(),
         username_,
         rankList_.getBestScore(),
         "You Win! Press any key to continue..."
@@ -142,68 +522,172 @@ void Game::handleWonState() {
 }
 
 void Game::handleGameOverState() {
-    renderer_.render(
+    fillBoardFrame(
         board_,
-        animator_.getVisualTiles(),
         username_,
         rankList_.getBestScore(),
-        "Game Over! Press R to restart..."
+        hardModeUsed_ ? "Game Over! R: restart" : "Game Over! R: restart  V: replay",
+        gameOverSummary_
     );
 }
 
-void Game::processInput() {
+void Game::processInput(sf::Keyboard::Key key) {
     if (state_ == GameState::MENU) {
+        // 输入名字时，上下键选择补全建议，回车确认
+        if (!menu_.getSuggestions().empty()) {
+            if (key == sf::Keyboard::Up) {
+                menu_.moveSuggestionSelection(-1);
+                return;
+            }
+            if (key == sf::Keyboard::Down) {
+                menu_.moveSuggestionSelection(1);
+                return;
+            }
+            if (key == sf::Keyboard::Return && menu_.getSelectedSuggestion() >= 0) {
+                menu_.acceptSuggestion();
+                return;
+            }
+        }
+        
         // 菜单状态下支持快捷键
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Return)) {
-            if (saveManager_.hasSave()) {
+        if (key == sf::Keyboard::Return) {
+            if (hasSave()) {
                 continueGame();
             } else {
                 username_ = menu_.getPlayerName();
                 startNewGame();
             }
-        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::N)) {
-            if (saveManager_.hasSave()) {
+        } else if (key == sf::Keyboard::N) {
+            if (hasSave()) {
                 username_ = menu_.getPlayerName();
                 startNewGame();
             }
-        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::R)) {
+        } else if (key == sf::Keyboard::R) {
+            menu_.resetRankScroll();
             state_ = GameState::RANK_LIST;
-        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape)) {
-            window_.close();
+        } else if (key == sf::Keyboard::F2) {
+            // 观看最近一局的回放（replays/ 中最新的文件）
+            std::error_code ec;
+            std::filesystem::path latest;
+            for (const auto& entry : std::filesystem::directory_iterator("replays", ec)) {
+                if (entry.path().extension() == ".rpl" && entry.path().filename() > latest.filename()) {
+                    latest = entry.path();
+                }
+            }
+            Replay replay;
+            if (!latest.empty() && replay.readFrom(latest.string())) {
+                startReplay(replay);
+            }
+        } else if (key == sf::Keyboard::Escape) {
+            quitRequested_.store(true);
         }
     } else if (state_ == GameState::RANK_LIST) {
-        // 排行榜状态下按ESC返回
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape)) {
+        // 排行榜状态下按ESC返回，上下/翻页键滚动，左右键切换总榜/本周/今日
+        int pageRows = static_cast<int>(Menu::RANK_VISIBLE_ROWS);
+        if (key == sf::Keyboard::Escape) {
             state_ = GameState::MENU;
-            menu_.setHasSaveFile(saveManager_.hasSave());
+            menu_.setHasSaveFile(hasSave());
+        } else if (key == sf::Keyboard::Up) {
+            menu_.scrollRankList(-1, rankList_.size());
+        } else if (key == sf::Keyboard::Down) {
+            menu_.scrollRankList(1, rankList_.size());
+        } else if (key == sf::Keyboard::PageUp) {
+            menu_.scrollRankList(-pageRows, rankList_.size());
+        } else if (key == sf::Keyboard::PageDown) {
+            menu_.scrollRankList(pageRows, rankList_.size());
+        } else if (key == sf::Keyboard::Left) {
+            menu_.cycleRankPeriod(-1);
+        } else if (key == sf::Keyboard::Right) {
+            menu_.cycleRankPeriod(1);
         }
     } else if (state_ == GameState::PLAYING) {
+        // A 开关自动走子，P 切换策略（动画中也可以）
+        if (key == sf::Keyboard::A) {
+            setAutoplay(!autoplay_);
+            return;
+        } else if (key == sf::Keyboard::P) {
+            cycleAutoplayPolicy();
+            return;
+        } else if (key == sf::Keyboard::H) {
+            // 困难模式从下一个新方块开始生效
+            hardMode_ = !hardMode_;
+            if (!hardMode_) {
+                evilSpawner_.cancel();
+            }
+            return;
+        } else if (key == sf::Keyboard::T) {
+            hintEnabled_ = !hintEnabled_;
+            if (!hintEnabled_) {
+                cancelHint();
+            }
+            return;
+        } else if (key == sf::Keyboard::F3) {
+            showJobStats_ = !showJobStats_;
+            return;
+        }
+        
         // 游戏中的方向键输入
         if (animator_.isAnimating()) {
             return;  // 动画进行中，锁定输入
         }
         
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) {
+        if (key == sf::Keyboard::Up) {
             handleMove(Direction::UP);
-        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) {
+        } else if (key == sf::Keyboard::Down) {
             handleMove(Direction::DOWN);
-        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) {
+        } else if (key == sf::Keyboard::Left) {
             handleMove(Direction::LEFT);
-        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) {
+        } else if (key == sf::Keyboard::Right) {
             handleMove(Direction::RIGHT);
+        } else if (key == sf::Keyboard::Z) {
+            undoMove();
+        } else if (key == sf::Keyboard::Y) {
+            redoMove();
         }
     } else if (state_ == GameState::WON) {
         // 胜利后可以继续玩
         state_ = GameState::PLAYING;
+    } else if (state_ == GameState::REPLAY) {
+        // 回放：空格暂停，上下键调倍速，左右键单步（暂停），翻页键按关键帧间隔跳转
+        size_t position = replayPlayer_.position();
+        size_t jump = ReplayPlayer::KEYFRAME_INTERVAL;
+        if (key == sf::Keyboard::Escape) {
+            animator_.stop();
+            animator_.resetPlaybackRate();
+            state_ = GameState::MENU;
+            menu_.setHasSaveFile(hasSave());
+        } else if (key == sf::Keyboard::Space) {
+            replayPaused_ = !replayPaused_;
+        } else if (key == sf::Keyboard::Up) {
+            setReplaySpeed(replaySpeedIndex_ + 1);
+        } else if (key == sf::Keyboard::Down) {
+            setReplaySpeed(replaySpeedIndex_ > 0 ? replaySpeedIndex_ - 1 : 0);
+        } else if (key == sf::Keyboard::Right) {
+            replayPaused_ = true;
+            seekReplay(position + 1);
+        } else if (key == sf::Keyboard::Left) {
+            replayPaused_ = true;
+            seekReplay(position > 0 ? position - 1 : 0);
+        } else if (key == sf::Keyboard::PageDown) {
+            seekReplay(position + jump);
+        } else if (key == sf::Keyboard::PageUp) {
+            seekReplay(position > jump ? position - jump : 0);
+        } else if (key == sf::Keyboard::Home) {
+            seekReplay(0);
+        } else if (key == sf::Keyboard::End) {
+            seekReplay(replayPlayer_.length());
+        }
     } else if (state_ == GameState::GAME_OVER) {
-        // 游戏结束，按任意键返回菜单
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::R)) {
+        // 游戏结束，按任意键返回菜单；V 观看本局回放
+        if (key == sf::Keyboard::V && !hardModeUsed_) {
+            startReplay(replay_);
+        } else if (key == sf::Keyboard::R) {
             state_ = GameState::MENU;
-            menu_.setHasSaveFile(saveManager_.hasSave());
+            menu_.setHasSaveFile(hasSave());
             menu_.clearPlayerName();
-        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape)) {
+        } else if (key == sf::Keyboard::Escape) {
             state_ = GameState::MENU;
-            menu_.setHasSaveFile(saveManager_.hasSave());
+            menu_.setHasSaveFile(hasSave());
             menu_.clearPlayerName();
         }
     }
@@ -221,6 +705,19 @@ void Game::handleMove(Direction dir) {
         return;  // 无效移动
     }
     
+    // 旧局面的提示立即作废，后台搜索停止
+    cancelHint();
+    
+    // 困难模式：移动后的局面已确定，生成器在移动动画期间搜索
+    if (hardMode_) {
+        Board after;
+        after.setGrid(result.grid);
+        uint64_t packed;
+        if (after.pack(packed)) {
+            evilSpawner_.request(packed);
+        }
+    }
+    
     // 生成移动事件（传入方向以避免斜向移动）数组
     auto events = computeMoveEvents(gridBefore, result.grid, dir);
     
@@ -228,11 +725,53 @@ void Game::handleMove(Direction dir) {
     animator_.startMoveAnimation(events, gridBefore);
     
     // 设置动画完成回调
-    animator_.setOnComplete([this, result]() {
-        onMoveAnimationComplete(result);
+    animator_.setOnComplete([this, result, dir]() {
+        onMoveAnimationComplete(result, dir);
     });
 }
 
+void Game::undoMove() {
+    Direction dir;
+    if (!history_.undo(board_, dir)) {
+        return;
+    }
+    cancelHint();
+    
+    // 倒放：从还原后的局面重新算出这一步的移动事件，再反向播放
+    int gridBefore[4][4];
+    board_.getGrid(gridBefore);
+    MoveResult result = board_.simulateMove(dir);
+    animator_.startReverseMoveAnimation(computeMoveEvents(gridBefore, result.grid, dir));
+    animator_.setOnComplete(nullptr);
+    
+    // 回放和步数同步回退（随机数状态也已还原，之后的新方块与回放一致）
+    moveCount_ = std::max(0, moveCount_ - 1);
+    if (replay_.moveCount() > 0) {
+        replay_.truncate(replay_.moveCount() - 1);
+    }
+    saveAsync();
+}
+
+void Game::redoMove() {
+    int gridBefore[4][4];
+    board_.getGrid(gridBefore);
+    Board previous = board_;
+    
+    Direction dir;
+    if (!history_.redo(board_, dir)) {
+        return;
+    }
+    cancelHint();
+    
+    MoveResult result = previous.simulateMove(dir);
+    animator_.startMoveAnimation(computeMoveEvents(gridBefore, result.grid, dir), gridBefore);
+    animator_.setOnComplete(nullptr);
+    
+    ++moveCount_;
+    replay_.append(dir);
+    saveAsync();
+}
+
 std::vector<MoveEvent> Game::computeMoveEvents(const int gridBefore[4][4], 
                                               const int gridAfter[4][4],
                                               Direction dir) {
@@ -482,13 +1021,18 @@ std::vector<MoveEvent> Game::computeMoveEvents(const int gridBefore[4][4],
     return events;
 }
 
-void Game::onMoveAnimationComplete(const MoveResult& result) {
+void Game::onMoveAnimationComplete(const MoveResult& result, Direction dir) {
     // 提交移动结果
     board_.commitGrid(result.grid);
     board_.addScore(result.scoreGain);
+    ++moveCount_;
+    replay_.append(dir);
     
     // 生成新方块
-    auto spawnInfo = board_.spawnNewTile();
+    auto spawnInfo = spawnTile();
+    
+    // 记入撤销历史（移动 + 新方块之后的局面）
+    history_.push(board_, dir);
     
     if (spawnInfo.first.first != -1) {
         // 启动生成动画
@@ -506,9 +1050,27 @@ void Game::onMoveAnimationComplete(const MoveResult& result) {
     }
 }
 
+std::pair<std::pair<int, int>, int> Game::spawnTile() {
+    uint64_t packed;
+    SpawnChoice choice;
+    if (!hardMode_ || !board_.pack(packed) || !evilSpawner_.take(packed, choice)) {
+        return board_.spawnNewTile();
+    }
+    
+    int row = choice.cell / 4;
+    int col = choice.cell % 4;
+    board_.placeTile(row, col, choice.value);
+    if (!hardModeUsed_) {
+        // 这个方块不来自随机数，回放从此无法重现：删掉未完成的回放，本局结束也不写回放
+        hardModeUsed_ = true;
+        io_.submit([this]() { saveManager_.deleteReplay(); });
+    }
+    return {{row, col}, choice.value};
+}
+
 void Game::onSpawnAnimationComplete() {
-    // 保存游戏
-    saveManager_.save(username_, board_);
+    // 保存游戏（连同回放，继续游戏后接着录制）
+    saveAsync();
     
     // 检查游戏状态
     checkGameState();
@@ -525,29 +1087,130 @@ void Game::checkGameState() {
         state_ = GameState::GAME_OVER;
         
         // 更新排行榜
-        rankList_.insertOrUpdate(username_, board_.getScore());
-        rankList_.save();
+        int score = board_.getScore();
+        rankList_.insertOrUpdate(username_, score);
+        io_.submit([this]() { rankList_.save(); });
+        
+        // 分数分布：超过多少玩家、今天对局的中位数（草图查询，不扫描排行榜）
+        int beatPercent = static_cast<int>(rankList_.percentileOf(score) * 100.0);
+        int todayMedian = rankList_.gameScoreSketch(ScorePeriod::TODAY).quantile(0.5);
+        gameOverSummary_ = "You beat " + std::to_string(beatPercent) + "% of players  |  Today's median: "
+                         + std::to_string(todayMedian);
+        
+        // 玩家统计：只改写该玩家在各列中的一个元素；写完后把局数和平均分补进结束说明
+        std::string username = username_;
+        int maxTile = board_.getMaxTile();
+        int moves = moveCount_;
+        io_.submit([this, username, score, maxTile, moves]() {
+            PlayerStatRow stats{};
+            if (!playerStats_.recordGame(username, score, maxTile, moves) || !playerStats_.get(username, stats)) {
+                stats.gamesPlayed = 0;
+            }
+            return stats;
+        }).then([this](const PlayerStatRow& stats) {
+            if (stats.gamesPlayed > 0 && state_ == GameState::GAME_OVER) {
+                gameOverSummary_ += "  |  Games: " + std::to_string(stats.gamesPlayed) + ", avg "
+                                  + std::to_string(static_cast<int>(stats.averageScore()));
+            }
+        });
+        
+        if (!hardModeUsed_) {
+            writeReplay(score);
+        }
         
-        // 删除存档
-        saveManager_.deleteSave();
+        // 删除存档（排在上面的写入之后）
+        io_.submit([this]() { saveManager_.deleteSave(); });
     }
 }
 
+void Game::writeReplay(int score) {
+    std::time_t now = std::time(nullptr);
+    replay_.finish(score, static_cast<int64_t>(now));
+    
+    // 文件名：时间_用户名.rpl（用户名中的路径分隔符替换掉）
+    std::string name = username_.empty() ? "player" : username_;
+    std::replace(name.begin(), name.end(), '/', '_');
+    std::string path = "replays/" + std::to_string(now) + "_" + name + ".rpl";
+    auto replay = std::make_shared<Replay>(replay_);
+    io_.submit([replay, path]() {
+        ::mkdir("replays", 0755);
+        if (!replay->writeTo(path)) {
+            std::cerr << "警告: 无法写入回放文件" << std::endl;
+        }
+    });
+}
+
+void Game::saveAsync() {
+    // 复制一份当前局面和回放交给 io_，逻辑线程不等待磁盘
+    std::string username = username_;
+    Board board = board_;
+    std::shared_ptr<Replay> replay;
+    if (!hardModeUsed_) {
+        replay = std::make_shared<Replay>(replay_);
+    }
+    io_.submit([this, username, board, replay]() {
+        saveManager_.save(username, board);
+        if (replay) {
+            saveManager_.saveReplay(*replay);
+        }
+    });
+}
+
+bool Game::hasSave() {
+    io_.flush();
+    return saveManager_.hasSave();
+}
+
+std::string Game::jobStatsText() const {
+    // 例：Jobs 2w  hi 0 (0.1ms)  mid 1 (3.2ms)  lo 0 (0.4ms)  steals 12
+    static const char* const kNames[JobSystem::PRIORITY_COUNT] = {"hi", "mid", "lo"};
+    JobStats stats = jobs_.stats();
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << "Jobs " << stats.workers << "w";
+    for (int p = 0; p < JobSystem::PRIORITY_COUNT; ++p) {
+        text << "  " << kNames[p] << " " << stats.queued[p] << " (" << stats.waitMs[p] << "ms)";
+    }
+    text << "  steals " << stats.steals;
+    return text.str();
+}
+
 void Game::startNewGame() {
     board_.init();
     state_ = GameState::PLAYING;
+    setAutoplay(false);
+    cancelHint();
+    hardModeUsed_ = false;
     wonDisplayed_ = false;
+    moveCount_ = 0;
     
     // 删除旧存档
-    saveManager_.deleteSave();
+    io_.submit([this]() { saveManager_.deleteSave(); });
+    
+    // 从初始局面开始录制回放和撤销历史
+    replay_.begin(username_, board_);
+    history_.reset(board_);
     
     // 保存新游戏
-    saveManager_.save(username_, board_);
+    saveAsync();
 }
 
 void Game::continueGame() {
+    io_.flush();  // 读之前等后台写完
     if (saveManager_.load(username_, board_)) {
         state_ = GameState::PLAYING;
+        setAutoplay(false);
+        cancelHint();
+        hardModeUsed_ = false;
+        
+        // 接着存档里的回放录制，步数取回放中已有的步数；旧存档没有回放，或回放与存档不一致
+        // （两个文件分开写，崩溃时可能错开），则从当前局面重新开始，步数从0计
+        if (saveManager_.loadReplay(replay_) && replayMatchesBoard()) {
+            moveCount_ = static_cast<int>(replay_.moveCount());
+        } else {
+            replay_.begin(username_, board_);
+            moveCount_ = 0;
+        }
+        history_.reset(board_);
         wonDisplayed_ = board_.hasWon();  // 如果已经胜利过，不再显示胜利消息
     } else {
         // 加载失败，开始新游戏
@@ -556,6 +1219,25 @@ void Game::continueGame() {
     }
 }
 
+bool Game::replayMatchesBoard() const {
+    if (replay_.username() != username_) {
+        return false;
+    }
+    
+    // 重放全部步数，网格、分数和随机数状态都要与存档一致
+    Board end;
+    if (!replay_.play(end) || end.getScore() != board_.getScore() ||
+        end.getRngState() != board_.getRngState()) {
+        return false;
+    }
+    for (int i = 0; i < 16; ++i) {
+        if (end.getValue(i / 4, i % 4) != board_.getValue(i / 4, i % 4)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void Game::getUsernameInput() {
     // 从Menu获取用户输入的名称
     username_ = menu_.getPlayerName();
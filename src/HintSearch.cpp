@@ -0,0 +1,276 @@
+#include "HintSearch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const size_t kTableSize = 1 << 16;
+const float kNegative = -1e30f;
+
+// 没有网络时的后状态估值：空格数为主，相邻可合并的对数为辅（与得分同量级）
+float heuristic(uint64_t board) {
+    int empty = Board::emptyCount(board);
+    int pairs = 0;
+    for (int i = 0; i < 16; ++i) {
+        uint64_t value = (board >> (4 * i)) & 0xf;
+        if (value == 0) continue;
+        if (i % 4 < 3 && ((board >> (4 * (i + 1))) & 0xf) == value) ++pairs;
+        if (i < 12 && ((board >> (4 * (i + 4))) & 0xf) == value) ++pairs;
+    }
+    return static_cast<float>(empty * 64 + pairs * 16);
+}
+
+// 置信度：最佳方向领先第二名的幅度，领先5%记为100；只有一个合法方向时为100
+int confidenceOf(const float values[4], int best) {
+    float second = kNegative;
+    for (int d = 0; d < 4; ++d) {
+        if (d != best) second = std::max(second, values[d]);
+    }
+    if (second <= kNegative) {
+        return 100;
+    }
+    float lead = (values[best] - second) / (0.05f * std::fabs(values[best]) + 1.0f);
+    return std::min(100, static_cast<int>(lead * 100.0f + 0.5f));
+}
+
+// 一次搜索的上下文：编号变化（取消或新请求）和截止时间每1024个节点检查一次，中止后整层作废
+struct Search {
+    const NTupleNetwork* network;
+    HintEntry* table;   // 为空时不用置换表
+    const std::atomic<uint32_t>* generation;
+    uint32_t expected;
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t nodes;
+    bool aborted;
+    
+    Search() : network(nullptr), table(nullptr), generation(nullptr), expected(0),
+               hasDeadline(false), nodes(0), aborted(false) {}
+    
+    bool checkAbort() {
+        if ((++nodes & 1023) == 0) {
+            if ((generation && generation->load(std::memory_order_relaxed) != expected) ||
+                (hasDeadline && std::chrono::steady_clock::now() >= deadline)) {
+                aborted = true;
+            }
+        }
+        return aborted;
+    }
+    
+    // 移动后的局面：深度用完时直接估值，否则进入机会节点
+    float afterstate(uint64_t after, int depth) {
+        if (depth <= 1) {
+            return network ? network->evaluate(after) : heuristic(after);
+        }
+        return chance(after, depth - 1);
+    }
+    
+    // 玩家节点：即时得分 + 后状态的值，取四个方向中最大的；无法移动记为0（游戏结束）
+    float player(uint64_t board, int depth) {
+        if (checkAbort()) return 0.0f;
+        float best = 0.0f;
+        for (int d = 0; d < 4; ++d) {
+            int gain = 0;
+            uint64_t after = Board::movePacked(board, static_cast<Direction>(d), &gain);
+            if (after == board) continue;
+            best = std::max(best, gain + afterstate(after, depth));
+        }
+        return best;
+    }
+    
+    // 机会节点：所有空格等概率，2 占 0.9、4 占 0.1
+    float chance(uint64_t after, int depth) {
+        uint64_t key = 0;
+        HintEntry* entry = nullptr;
+        if (table) {
+            key = Board::canonical(after);
+            entry = &table[(key * 0x9E3779B97F4A7C15ULL) >> 48];
+            if (entry->key == key && entry->depth >= depth) {
+                return entry->value;
+            }
+        }
+        
+        float sum = 0.0f;
+        int empty = 0;
+        for (int i = 0; i < 16; ++i) {
+            if (((after >> (4 * i)) & 0xf) != 0) continue;
+            ++empty;
+            sum += 0.9f * player(after | (1ULL << (4 * i)), depth);
+            sum += 0.1f * player(after | (2ULL << (4 * i)), depth);
+            if (aborted) return 0.0f;
+        }
+        float value = empty > 0 ? sum / empty : 0.0f;
+        if (entry) {
+            entry->key = key;
+            entry->value = value;
+            entry->depth = depth;
+        }
+        return value;
+    }
+    
+    // 根节点：分别求四个方向的值；中止或无合法方向返回false
+    bool root(uint64_t board, int depth, Hint& hint, float* value = nullptr) {
+        float values[4];
+        int best = -1;
+        for (int d = 0; d < 4; ++d) {
+            int gain = 0;
+            uint64_t after = Board::movePacked(board, static_cast<Direction>(d), &gain);
+            values[d] = kNegative;
+            if (after == board) continue;
+            values[d] = gain + afterstate(after, depth);
+            if (aborted) return false;
+            if (best < 0 || values[d] > values[best]) {
+                best = d;
+            }
+        }
+        if (best < 0) return false;
+        hint.dir = static_cast<Direction>(best);
+        hint.confidence = confidenceOf(values, best);
+        hint.depth = depth;
+        if (value) {
+            *value = values[best];
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+HintSearch::HintSearch(JobSystem& jobs)
+    : network_(nullptr),
+      book_(nullptr),
+      table_(kTableSize),
+      clearTable_(true),
+      generation_(0),
+      slot_(0),
+      strand_(jobs, JobPriority::HIGH) {
+}
+
+HintSearch::~HintSearch() {
+    // 正在进行的搜索在下一次检查时放弃，排队中的任务开始时直接返回；strand_ 析构时等它们结束
+    generation_.fetch_add(1);
+}
+
+void HintSearch::setBook(const OpeningBook* book) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    book_ = book;
+}
+
+void HintSearch::setEvaluator(const NTupleNetwork* network) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_.fetch_add(1);
+    network_ = network;
+    clearTable_ = true;  // 换了估值，旧表项作废
+}
+
+uint32_t HintSearch::request(uint64_t packed) {
+    Search search;
+    const OpeningBook* book;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        book = book_;
+        search.network = network_;
+    }
+    
+    // 开局库命中：直接发布预计算的结果，不启动后台搜索
+    BookMove move;
+    bool inBook = book != nullptr && book->lookup(packed, move);
+    
+    uint32_t generation = generation_.fetch_add(1) + 1;  // 旧局面的搜索尽快结束
+    
+    Hint hint;
+    if (inBook) {
+        hint.dir = move.dir;
+        hint.confidence = move.confidence;
+        hint.depth = move.depth;
+        publish(generation, hint);
+        return generation;
+    }
+    
+    // 一步贪心：几次查表，当场完成
+    if (search.root(packed, 1, hint)) {
+        publish(generation, hint);
+    }
+    strand_.submit([this, packed, generation]() { deepen(packed, generation); });
+    return generation;
+}
+
+void HintSearch::cancel() {
+    generation_.fetch_add(1);
+}
+
+bool HintSearch::current(uint32_t generation, Hint& hint) const {
+    uint64_t slot = slot_.load(std::memory_order_acquire);
+    if (static_cast<uint32_t>(slot >> 32) != generation || generation_.load() != generation) {
+        return false;
+    }
+    hint.depth = static_cast<int>((slot >> 16) & 0xff);
+    hint.confidence = static_cast<int>((slot >> 8) & 0xff);
+    hint.dir = static_cast<Direction>(slot & 0xff);
+    return hint.depth > 0;
+}
+
+bool HintSearch::search(uint64_t packed, int depth, const NTupleNetwork* network, Hint& hint, float* value) {
+    // 深度3起才有重复的机会节点，浅搜索不分配置换表（策略逐步调用时省去每步1MB的清零）
+    std::vector<HintEntry> table(depth >= 3 ? kTableSize : 0);
+    Search search;
+    search.network = network;
+    search.table = depth >= 3 ? table.data() : nullptr;
+    for (int d = 1; d <= depth; ++d) {
+        if (!search.root(packed, d, hint, value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HintSearch::publish(uint32_t generation, const Hint& hint) {
+    uint64_t slot = static_cast<uint64_t>(generation) << 32 |
+                    static_cast<uint64_t>(hint.depth & 0xff) << 16 |
+                    static_cast<uint64_t>(hint.confidence & 0xff) << 8 |
+                    static_cast<uint64_t>(static_cast<int>(hint.dir) & 0xff);
+    
+    // 只有更新的请求或同一请求更深的结果才能覆盖槽位（同步的一步提示可能晚于后台第2层写入）
+    uint64_t old = slot_.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t oldGeneration = static_cast<uint32_t>(old >> 32);
+        int oldDepth = static_cast<int>((old >> 16) & 0xff);
+        if (oldGeneration > generation || (oldGeneration == generation && oldDepth >= hint.depth)) {
+            return;
+        }
+        if (slot_.compare_exchange_weak(old, slot, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+void HintSearch::deepen(uint64_t board, uint32_t generation) {
+    // 排队期间已被新请求取代或取消：不必开始
+    if (generation_.load() != generation) {
+        return;
+    }
+    
+    // 迭代加深：第1层已由 request 当场发布，从第2层开始，每完成一层发布一次
+    Search search;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        search.network = network_;
+        if (clearTable_) {
+            std::fill(table_.begin(), table_.end(), HintEntry());
+            clearTable_ = false;
+        }
+    }
+    search.table = table_.data();
+    search.generation = &generation_;
+    search.expected = generation;
+    search.hasDeadline = true;
+    search.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(MAX_SEARCH_MS);
+    
+    Hint hint;
+    for (int depth = 2; depth <= MAX_DEPTH; ++depth) {
+        if (!search.root(board, depth, hint)) {
+            break;
+        }
+        publish(generation, hint);
+    }
+}
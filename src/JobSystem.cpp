@@ -0,0 +1,213 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// 当前线程所属的任务系统和工作线程下标（外部线程为空）
+thread_local const JobSystem* tCurrentSystem = nullptr;
+thread_local int tCurrentWorker = -1;
+
+// 指数滑动平均：新样本占1/8（无锁，多个工作线程同时更新时偶尔丢一个样本无妨）
+void updateAverage(std::atomic<uint64_t>& average, uint64_t sample) {
+    uint64_t old = average.load(std::memory_order_relaxed);
+    uint64_t next = old - old / 8 + sample / 8;
+    average.compare_exchange_weak(old, next, std::memory_order_relaxed);
+}
+
+uint64_t microsSince(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+}
+
+} // namespace
+
+JobSystem::JobSystem(int workers)
+    : nextWorker_(0),
+      pending_(0),
+      stopping_(false),
+      steals_(0) {
+    if (workers <= 0) {
+        workers = std::max(2, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int p = 0; p < PRIORITY_COUNT; ++p) {
+        queued_[p] = 0;
+        completed_[p] = 0;
+        waitMicros_[p] = 0;
+        runMicros_[p] = 0;
+    }
+    for (int i = 0; i < workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < workers; ++i) {
+        threads_.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void JobSystem::push(JobPriority priority, std::function<void()> run) {
+    int p = static_cast<int>(priority);
+    int target = tCurrentSystem == this ? tCurrentWorker
+                                        : static_cast<int>(nextWorker_.fetch_add(1) % workers_.size());
+    // 计数先于入队增加（取走时减少，不会出现负数），且在通知前增加，等待中的线程检查条件时一定能看到
+    queued_[p].fetch_add(1, std::memory_order_relaxed);
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+        workers_[target]->queues[p].push_back(Job{std::move(run), Clock::now()});
+    }
+    
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    wake_.notify_one();
+}
+
+bool JobSystem::pop(int self, Job& job, int& priority) {
+    size_t count = workers_.size();
+    for (int p = 0; p < PRIORITY_COUNT; ++p) {
+        // 先取自己队列的尾部，再从其他线程队列的头部偷
+        for (size_t k = 0; k < count; ++k) {
+            Worker& worker = *workers_[(self + k) % count];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            std::deque<Job>& queue = worker.queues[p];
+            if (queue.empty()) {
+                continue;
+            }
+            if (k == 0) {
+                job = std::move(queue.back());
+                queue.pop_back();
+            } else {
+                job = std::move(queue.front());
+                queue.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+            }
+            priority = p;
+            queued_[p].fetch_sub(1, std::memory_order_relaxed);
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(int index) {
+    tCurrentSystem = this;
+    tCurrentWorker = index;
+    
+    Job job;
+    int priority = 0;
+    while (true) {
+        if (!pop(index, job, priority)) {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this]() { return stopping_ || pending_.load(std::memory_order_acquire) > 0; });
+            if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+                return;  // 已提交的任务都执行完才退出
+            }
+            continue;
+        }
+        
+        Clock::time_point start = Clock::now();
+        updateAverage(waitMicros_[priority], microsSince(job.queuedAt, start));
+        try {
+            job.run();
+        } catch (...) {
+            // 带结果的任务已在包装中捕获并记录异常，这里只剩内部任务（strand 的调度）
+            logFailure(std::current_exception());
+        }
+        job.run = nullptr;  // 尽早释放任务捕获的数据
+        updateAverage(runMicros_[priority], microsSince(start, Clock::now()));
+        completed_[priority].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void JobSystem::logFailure(const std::exception_ptr& error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        std::cerr << "警告: 后台任务异常: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "警告: 后台任务抛出了未知类型的异常" << std::endl;
+    }
+}
+
+void JobSystem::postCompletion(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(completionMutex_);
+    completions_.push_back(std::move(callback));
+}
+
+size_t JobSystem::runCompletions() {
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        ready.swap(completions_);
+    }
+    for (auto& callback : ready) {
+        callback();
+    }
+    return ready.size();
+}
+
+JobStats JobSystem::stats() const {
+    JobStats stats;
+    stats.workers = workerCount();
+    for (int p = 0; p < PRIORITY_COUNT; ++p) {
+        stats.queued[p] = queued_[p].load(std::memory_order_relaxed);
+        stats.completed[p] = completed_[p].load(std::memory_order_relaxed);
+        stats.waitMs[p] = waitMicros_[p].load(std::memory_order_relaxed) / 1000.0;
+        stats.runMs[p] = runMicros_[p].load(std::memory_order_relaxed) / 1000.0;
+    }
+    stats.steals = steals_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+JobStrand::JobStrand(JobSystem& system, JobPriority priority)
+    : system_(system),
+      priority_(priority),
+      running_(false) {
+}
+
+JobStrand::~JobStrand() {
+    flush();
+}
+
+void JobStrand::post(std::function<void()> run) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(run));
+    if (!running_) {
+        running_ = true;
+        system_.push(priority_, [this]() { drain(); });
+    }
+}
+
+void JobStrand::drain() {
+    // 依次执行队列中的任务；执行期间新提交的任务也由这里接着执行
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!jobs_.empty()) {
+        std::function<void()> run = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        run();
+        run = nullptr;
+        lock.lock();
+    }
+    running_ = false;
+    idle_.notify_all();
+}
+
+void JobStrand::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return !running_; });
+}
+
+size_t JobStrand::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
@@ -8,8 +8,10 @@ bool Button::contains(int mouseX, int mouseY) const {
 
 // Menu构造函数
 Menu::Menu() : playerName(""), hasSaveFile(false), inputActive(false), hoveredButton(-1),
+               rankScrollOffset(0), rankPeriod(RankPeriod::ALL_TIME),
                inputBoxX(100), inputBoxY(230),  // 居中：(600-400)/2 = 100
-               inputBoxWidth(400), inputBoxHeight(60) {
+               inputBoxWidth(400), inputBoxHeight(60),
+               selectedSuggestion(-1) {
     initButtons();
 }
 
@@ -89,12 +91,14 @@ void Menu::setPlayerName(const std::string& name) {
 void Menu::clearPlayerName() {
     playerName.clear();
     inputActive = false;
+    updateSuggestions();
 }
 
 bool Menu::checkInputBoxClick(int mouseX, int mouseY) {
     if (mouseX >= inputBoxX && mouseX <= inputBoxX + inputBoxWidth &&
         mouseY >= inputBoxY && mouseY <= inputBoxY + inputBoxHeight) {
         inputActive = true;
+        updateSuggestions();
         return true;
     }
     return false;
@@ -106,6 +110,7 @@ bool Menu::isInputActive() const {
 
 void Menu::deactivateInput() {
     inputActive = false;
+    updateSuggestions();
 }
 
 void Menu::handleTextInput(sf::Uint32 unicode) {
@@ -122,6 +127,10 @@ void Menu::handleTextInput(sf::Uint32 unicode) {
                 playerName.pop_back();
             }
         }
+        // Tab键：接受补全建议
+        else if (inputChar == '\t') {
+            acceptSuggestion();
+        }
         // 可打印字符
         else if (inputChar >= 32 && inputChar < 127 && playerName.length() < 20) {
             playerName += inputChar;
@@ -141,6 +150,78 @@ void Menu::handleTextInput(sf::Uint32 unicode) {
             }
         }
     }
+    
+    updateSuggestions();
+}
+
+uint64_t Menu::getNameIndexVersion() const {
+    return nameIndex ? nameIndex->version() : 0;
+}
+
+void Menu::setNameIndex(std::shared_ptr<const PrefixIndex> index) {
+    // 旧建议里的名字引用旧索引持有的快照，换入后立即重新查询
+    nameIndex = std::move(index);
+    updateSuggestions();
+}
+
+void Menu::updateSuggestions() {
+    selectedSuggestion = -1;
+    
+    if (!inputActive || playerName.empty() || !nameIndex) {
+        suggestions.clear();
+        return;
+    }
+    
+    nameIndex->complete(playerName, MAX_SUGGESTIONS, suggestions);
+}
+
+const std::vector<RankEntryView>& Menu::getSuggestions() const {
+    return suggestions;
+}
+
+int Menu::getSelectedSuggestion() const {
+    return selectedSuggestion;
+}
+
+void Menu::moveSuggestionSelection(int delta) {
+    if (suggestions.empty()) {
+        return;
+    }
+    
+    int count = static_cast<int>(suggestions.size());
+    selectedSuggestion = (selectedSuggestion + delta + count + 1) % (count + 1) - 1;  // -1 也在循环中
+}
+
+bool Menu::acceptSuggestion() {
+    if (suggestions.empty()) {
+        return false;
+    }
+    
+    size_t index = selectedSuggestion >= 0 ? static_cast<size_t>(selectedSuggestion) : 0;
+    playerName = std::string(suggestions[index].username);
+    suggestions.clear();
+    selectedSuggestion = -1;
+    return true;
+}
+
+bool Menu::handleSuggestionClick(int mouseX, int mouseY) {
+    for (size_t i = 0; i < suggestions.size(); ++i) {
+        float x, y, width, height;
+        getSuggestionBox(i, x, y, width, height);
+        if (mouseX >= x && mouseX <= x + width && mouseY >= y && mouseY <= y + height) {
+            selectedSuggestion = static_cast<int>(i);
+            return acceptSuggestion();
+        }
+    }
+    return false;
+}
+
+void Menu::getSuggestionBox(size_t index, float& x, float& y, float& width, float& height) const {
+    // 紧贴输入框下方的下拉列表
+    x = inputBoxX;
+    y = inputBoxY + inputBoxHeight + 2 + index * 36.0f;
+    width = inputBoxWidth;
+    height = 34;
 }
 
 MenuAction Menu::handleClick(int mouseX, int mouseY) {
@@ -197,6 +278,42 @@ const Button& Menu::getBackButton() const {
     return backButton;
 }
 
+void Menu::scrollRankList(int deltaRows, size_t totalRows) {
+    // 最大偏移：最后一屏正好填满
+    size_t maxOffset = totalRows > RANK_VISIBLE_ROWS ? totalRows - RANK_VISIBLE_ROWS : 0;
+    
+    if (deltaRows < 0) {
+        size_t up = static_cast<size_t>(-deltaRows);
+        rankScrollOffset = rankScrollOffset > up ? rankScrollOffset - up : 0;
+    } else {
+        rankScrollOffset += static_cast<size_t>(deltaRows);
+    }
+    
+    if (rankScrollOffset > maxOffset) {
+        rankScrollOffset = maxOffset;
+    }
+}
+
+void Menu::resetRankScroll() {
+    rankScrollOffset = 0;
+}
+
+size_t Menu::getRankScrollOffset() const {
+    return rankScrollOffset;
+}
+
+void Menu::cycleRankPeriod(int delta) {
+    // 总榜 -> 本周 -> 今日 循环切换
+    int count = 3;
+    int index = (static_cast<int>(rankPeriod) + delta % count + count) % count;
+    rankPeriod = static_cast<RankPeriod>(index);
+    rankScrollOffset = 0;
+}
+
+RankPeriod Menu::getRankPeriod() const {
+    return rankPeriod;
+}
+
 void Menu::getInputBox(float& x, float& y, float& width, float& height) const {
     x = inputBoxX;
     y = inputBoxY;
@@ -211,6 +328,16 @@ bool Menu::hasLoadGame() const {
 void Menu::updateHover(int mouseX, int mouseY) {
     hoveredButton = -1;
     
+    // 悬停在补全建议上时选中该行（建议列表覆盖在按钮之上）
+    for (size_t i = 0; i < suggestions.size(); ++i) {
+        float x, y, width, height;
+        getSuggestionBox(i, x, y, width, height);
+        if (mouseX >= x && mouseX <= x + width && mouseY >= y && mouseY <= y + height) {
+            selectedSuggestion = static_cast<int>(i);
+            return;
+        }
+    }
+    
     // 检查输入框
     if (mouseX >= inputBoxX && mouseX <= inputBoxX + inputBoxWidth &&
         mouseY >= inputBoxY && mouseY <= inputBoxY + inputBoxHeight) {
@@ -268,3 +395,41 @@ bool Menu::isButtonHovered(const Button& button) const {
     return false;
 }
 
+void Menu::fillView(MenuView& view) const {
+    view.playerName = getPlayerName();
+    view.inputActive = inputActive;
+    view.inputBoxHovered = isInputBoxHovered();
+    getInputBox(view.inputBoxX, view.inputBoxY, view.inputBoxWidth, view.inputBoxHeight);
+    
+    // 有存档时显示继续/新游戏，否则显示开始
+    const Button* visible[4];
+    size_t count = 0;
+    if (hasSaveFile) {
+        visible[count++] = &continueButton;
+        visible[count++] = &newGameButton;
+    } else {
+        visible[count++] = &startButton;
+    }
+    visible[count++] = &rankButton;
+    visible[count++] = &quitButton;
+    view.buttons.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        view.buttons[i].button = *visible[i];
+        view.buttons[i].hovered = isButtonHovered(*visible[i]);
+    }
+    view.backButton.button = backButton;
+    view.backButton.hovered = isButtonHovered(backButton);
+    
+    // 建议的用户名指向排行榜快照，复制成字符串后渲染线程不再依赖快照
+    view.suggestions.resize(suggestions.size());
+    for (size_t i = 0; i < suggestions.size(); ++i) {
+        MenuView::SuggestionView& row = view.suggestions[i];
+        row.username.assign(suggestions[i].username.data(), suggestions[i].username.size());
+        row.score = suggestions[i].score;
+        getSuggestionBox(i, row.x, row.y, row.width, row.height);
+        row.selected = static_cast<int>(i) == selectedSuggestion;
+    }
+    
+    view.rankScrollOffset = rankScrollOffset;
+    view.rankPeriod = rankPeriod;
+}
@@ -0,0 +1,215 @@
+#include "MonteCarloAI.h"
+#include <chrono>
+
+MonteCarloAI::MonteCarloAI(JobSystem& jobs)
+    : budgetMs_(DEFAULT_BUDGET_MS),
+      policy_(PlayoutPolicy::RANDOM),
+      rngState_(Board::randomSeed()),
+      requestGeneration_(0),
+      hasRequest_(false),
+      busy_(false),
+      hasResult_(false),
+      resultBoard_(0),
+      resultDir_(Direction::UP),
+      lastStats_(),
+      cancelled_(false),
+      strand_(jobs, JobPriority::NORMAL) {
+}
+
+MonteCarloAI::~MonteCarloAI() {
+    // 正在进行的决策尽快结束；strand_ 析构时等它返回
+    cancel();
+}
+
+void MonteCarloAI::setTimeBudget(int milliseconds) {
+    budgetMs_ = milliseconds < 1 ? 1 : milliseconds;
+}
+
+void MonteCarloAI::setPlayoutPolicy(PlayoutPolicy policy) {
+    policy_ = policy;
+}
+
+uint64_t MonteCarloAI::runBatch(uint64_t afterstate, PlayoutPolicy policy, uint64_t& moves) {
+    // 活跃的模拟压缩在数组前部：结束的与最后一个活跃的交换，每步只扫描连续的活跃段
+    uint64_t boards[BATCH_SIZE];
+    uint32_t scores[BATCH_SIZE];
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        boards[i] = Board::spawnPacked(afterstate, rngState_);
+        scores[i] = 0;
+    }
+    
+    // 方向用 xorshift64 的每2位取一次，一个64位随机数够32步
+    uint64_t dirRandom = rngState_ | 1;
+    uint64_t bits = 0;
+    int bitsLeft = 0;
+    
+    uint64_t total = 0;
+    int alive = BATCH_SIZE;
+    while (alive > 0) {
+        for (int i = 0; i < alive;) {
+            uint64_t board = boards[i];
+            uint64_t next = board;
+            int gain = 0;
+            // 起始方向随机，依次尝试：随机策略取第一个有效方向，贪心策略取得分最大的（同分取先试到的）
+            if (bitsLeft == 0) {
+                dirRandom ^= dirRandom << 13;
+                dirRandom ^= dirRandom >> 7;
+                dirRandom ^= dirRandom << 17;
+                bits = dirRandom;
+                bitsLeft = 32;
+            }
+            int start = static_cast<int>(bits & 3);
+            bits >>= 2;
+            --bitsLeft;
+            int bestGain = -1;
+            for (int k = 0; k < 4; ++k) {
+                int moveGain = 0;
+                uint64_t moved = Board::movePacked(board, static_cast<Direction>((start + k) & 3), &moveGain);
+                if (moved != board && moveGain > bestGain) {
+                    next = moved;
+                    gain = moveGain;
+                    bestGain = moveGain;
+                    if (policy == PlayoutPolicy::RANDOM) {
+                        break;
+                    }
+                }
+            }
+            
+            if (next == board) {
+                // 无法移动：记入总分，用最后一个活跃模拟填补空位
+                total += scores[i];
+                --alive;
+                boards[i] = boards[alive];
+                scores[i] = scores[alive];
+                continue;
+            }
+            scores[i] += static_cast<uint32_t>(gain);
+            boards[i] = Board::spawnPacked(next, rngState_);
+            ++moves;
+            ++i;
+        }
+    }
+    return total;
+}
+
+bool MonteCarloAI::chooseMove(uint64_t packed, Direction& dir, MonteCarloStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    MonteCarloStats result = {};
+    
+    uint64_t afterstates[4];
+    int gains[4];
+    int candidates[4];
+    int candidateCount = 0;
+    for (int d = 0; d < 4; ++d) {
+        afterstates[d] = Board::movePacked(packed, static_cast<Direction>(d), &gains[d]);
+        result.meanScore[d] = -1.0;
+        if (afterstates[d] != packed) {
+            candidates[candidateCount++] = d;
+        }
+    }
+    if (candidateCount == 0) {
+        if (stats) {
+            *stats = result;
+        }
+        return false;
+    }
+    
+    // 各方向轮流跑一批，直到时间用完（至少跑完一轮）；只有一个合法方向时不必模拟
+    uint64_t sums[4] = {0, 0, 0, 0};
+    uint64_t counts[4] = {0, 0, 0, 0};
+    PlayoutPolicy policy = policy_.load();
+    auto budget = std::chrono::milliseconds(budgetMs_.load());
+    while (candidateCount > 1) {
+        for (int c = 0; c < candidateCount; ++c) {
+            int d = candidates[c];
+            sums[d] += runBatch(afterstates[d], policy, result.moves);
+            counts[d] += BATCH_SIZE;
+        }
+        if (cancelled_.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() - start >= budget) {
+            break;
+        }
+    }
+    
+    dir = static_cast<Direction>(candidates[0]);
+    double best = -1.0;
+    for (int c = 0; c < candidateCount; ++c) {
+        int d = candidates[c];
+        double mean = gains[d] + (counts[d] > 0 ? static_cast<double>(sums[d]) / counts[d] : 0.0);
+        result.meanScore[d] = mean;
+        result.playouts += counts[d];
+        if (mean > best) {
+            best = mean;
+            dir = static_cast<Direction>(d);
+        }
+    }
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (stats) {
+        *stats = result;
+    }
+    return true;
+}
+
+void MonteCarloAI::request(uint64_t packed) {
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation = ++requestGeneration_;
+        hasRequest_ = true;
+        hasResult_ = false;
+        cancelled_ = true;  // 让正在进行的旧决策尽快结束
+    }
+    strand_.submit([this, packed, generation]() { runDecision(packed, generation); });
+}
+
+bool MonteCarloAI::poll(uint64_t packed, Direction& dir) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasResult_ || resultBoard_ != packed) {
+        return false;
+    }
+    dir = resultDir_;
+    hasResult_ = false;
+    return true;
+}
+
+bool MonteCarloAI::isBusy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hasRequest_ || busy_;
+}
+
+void MonteCarloAI::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++requestGeneration_;
+    hasRequest_ = false;
+    hasResult_ = false;
+    cancelled_ = true;
+}
+
+MonteCarloStats MonteCarloAI::lastStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastStats_;
+}
+
+void MonteCarloAI::runDecision(uint64_t board, uint32_t generation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (generation != requestGeneration_) {
+        return;  // 排队期间已被新请求取代或取消
+    }
+    hasRequest_ = false;
+    busy_ = true;
+    cancelled_ = false;  // 串行队列中前一个决策已经结束，标记只属于本次
+    lock.unlock();
+    
+    Direction dir = Direction::UP;
+    MonteCarloStats stats;
+    bool found = chooseMove(board, dir, &stats);
+    
+    lock.lock();
+    busy_ = false;
+    // 计算期间被取消或被新请求取代的结果直接丢弃
+    if (found && generation == requestGeneration_ && !cancelled_) {
+        hasResult_ = true;
+        resultBoard_ = board;
+        resultDir_ = dir;
+        lastStats_ = stats;
+    }
+}
@@ -0,0 +1,83 @@
+#include "MoveHistory.h"
+
+namespace {
+
+const uint32_t kDrawMask = (1u << 30) - 1;
+
+} // namespace
+
+MoveHistory::MoveHistory(size_t capacity)
+    : entries_(capacity < 2 ? 2 : capacity), oldest_(0), count_(0), cursor_(0), rngBase_(0) {
+}
+
+void MoveHistory::reset(const Board& board) {
+    oldest_ = 0;
+    count_ = 0;
+    cursor_ = 0;
+    rngBase_ = board.getRngState();
+    
+    Entry entry;
+    if (board.pack(entry.grid)) {
+        entry.score = static_cast<uint32_t>(board.getScore());
+        entry.drawsAndDir = 0;
+        entries_[0] = entry;
+        count_ = 1;
+    }
+}
+
+void MoveHistory::push(const Board& board, Direction dir) {
+    Entry entry;
+    uint64_t draws = Board::rngDistance(rngBase_, board.getRngState());
+    if (!board.pack(entry.grid) || draws > kDrawMask) {
+        // 出现超过32768的方块（或生成次数溢出）：无法压缩表示，从这里重新开始记录
+        reset(board);
+        return;
+    }
+    entry.score = static_cast<uint32_t>(board.getScore());
+    entry.drawsAndDir = static_cast<uint32_t>(draws) | (static_cast<uint32_t>(dir) << 30);
+    
+    if (count_ == 0) {
+        reset(board);
+        return;
+    }
+    
+    // 丢弃可重做的部分，满了则覆盖最旧的记录
+    count_ = cursor_ + 1;
+    if (count_ == entries_.size()) {
+        oldest_ = (oldest_ + 1) % entries_.size();
+        --count_;
+        --cursor_;
+    }
+    
+    at(count_) = entry;
+    ++count_;
+    ++cursor_;
+}
+
+bool MoveHistory::undo(Board& board, Direction& dir) {
+    if (!canUndo()) {
+        return false;
+    }
+    
+    dir = static_cast<Direction>(at(cursor_).drawsAndDir >> 30);
+    --cursor_;
+    restore(at(cursor_), board);
+    return true;
+}
+
+bool MoveHistory::redo(Board& board, Direction& dir) {
+    if (!canRedo()) {
+        return false;
+    }
+    
+    ++cursor_;
+    dir = static_cast<Direction>(at(cursor_).drawsAndDir >> 30);
+    restore(at(cursor_), board);
+    return true;
+}
+
+void MoveHistory::restore(const Entry& entry, Board& board) const {
+    board.unpack(entry.grid);
+    board.setScore(static_cast<int>(entry.score));
+    board.setRngState(Board::rngAdvance(rngBase_, entry.drawsAndDir & kDrawMask));
+}
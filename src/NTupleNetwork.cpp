@@ -0,0 +1,224 @@
+#include "NTupleNetwork.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+const char kMagic[8] = {'2', '0', '4', '8', 'N', 'T', 'W', '1'};
+
+// Hogwild 更新：relaxed 原子读写（x86上就是普通的mov），不加锁，并发的加法偶尔互相覆盖
+inline float loadRelaxed(const float* p) {
+    float value;
+    __atomic_load(p, &value, __ATOMIC_RELAXED);
+    return value;
+}
+
+inline void storeRelaxed(float* p, float value) {
+    __atomic_store(p, &value, __ATOMIC_RELAXED);
+}
+
+} // namespace
+
+NTupleNetwork::NTupleNetwork() : tupleSize_(0), tableSize_(0), weights_(nullptr) {
+}
+
+std::vector<std::vector<int>> NTupleNetwork::defaultTuples() {
+    return {
+        {0, 1, 2, 3, 4, 5},
+        {4, 5, 6, 7, 8, 9},
+        {0, 1, 2, 4, 5, 6},
+        {4, 5, 6, 8, 9, 10},
+    };
+}
+
+std::vector<std::vector<int>> NTupleNetwork::smallTuples() {
+    return {
+        {0, 1, 2, 3},
+        {4, 5, 6, 7},
+        {0, 1, 4, 5},
+        {5, 6, 9, 10},
+    };
+}
+
+bool NTupleNetwork::setTuples(const std::vector<std::vector<int>>& tuples) {
+    if (tuples.empty() || tuples.size() > MAX_TUPLES) {
+        return false;
+    }
+    int size = static_cast<int>(tuples[0].size());
+    if (size == 0 || size > MAX_TUPLE_SIZE) {
+        return false;
+    }
+    for (const auto& tuple : tuples) {
+        if (static_cast<int>(tuple.size()) != size) {
+            return false;
+        }
+        for (int cell : tuple) {
+            if (cell < 0 || cell >= 16) {
+                return false;
+            }
+        }
+    }
+    
+    tuples_ = tuples;
+    tupleSize_ = size;
+    tableSize_ = size_t(1) << (4 * size);
+    
+    // 展开8种对称：第 s 种先按位决定左右翻转、上下翻转，再决定是否转置
+    cells_.assign(tuples.size() * 8 * size, 0);
+    for (size_t t = 0; t < tuples.size(); ++t) {
+        for (int s = 0; s < 8; ++s) {
+            for (int k = 0; k < size; ++k) {
+                int row = tuples[t][k] / 4;
+                int col = tuples[t][k] % 4;
+                if (s & 1) col = 3 - col;
+                if (s & 2) row = 3 - row;
+                if (s & 4) std::swap(row, col);
+                cells_[(t * 8 + s) * size + k] = static_cast<uint8_t>(row * 4 + col);
+            }
+        }
+    }
+    return true;
+}
+
+bool NTupleNetwork::create(const std::vector<std::vector<int>>& tuples) {
+    mapped_.close();
+    weights_ = nullptr;
+    if (!setTuples(tuples)) {
+        return false;
+    }
+    owned_.assign(weightCount(), 0.0f);
+    weights_ = owned_.data();
+    return true;
+}
+
+bool NTupleNetwork::readHeader(const char* data, size_t size) {
+    if (size < HEADER_SIZE || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    uint32_t count, length;
+    std::memcpy(&count, data + 8, 4);
+    std::memcpy(&length, data + 12, 4);
+    if (count == 0 || count > MAX_TUPLES || length == 0 || length > MAX_TUPLE_SIZE) {
+        return false;
+    }
+    
+    std::vector<std::vector<int>> tuples(count);
+    for (uint32_t t = 0; t < count; ++t) {
+        for (uint32_t k = 0; k < length; ++k) {
+            tuples[t].push_back(static_cast<uint8_t>(data[24 + t * 8 + k]));
+        }
+    }
+    return setTuples(tuples) && size == HEADER_SIZE + weightCount() * sizeof(float);
+}
+
+bool NTupleNetwork::open(const std::string& path) {
+    owned_.clear();
+    owned_.shrink_to_fit();
+    weights_ = nullptr;
+    if (!mapped_.open(path) || !readHeader(mapped_.data(), mapped_.size())) {
+        mapped_.close();
+        return false;
+    }
+    // 头部128字节，映射起点按页对齐，权重数组天然按float对齐
+    weights_ = reinterpret_cast<const float*>(mapped_.data() + HEADER_SIZE);
+    return true;
+}
+
+bool NTupleNetwork::load(const std::string& path) {
+    if (!open(path)) {
+        return false;
+    }
+    owned_.assign(weights_, weights_ + weightCount());
+    mapped_.close();
+    weights_ = owned_.data();
+    return true;
+}
+
+bool NTupleNetwork::saveTo(const std::string& path) const {
+    if (!isReady()) {
+        return false;
+    }
+    
+    char header[HEADER_SIZE] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    uint32_t count = static_cast<uint32_t>(tuples_.size());
+    uint32_t length = static_cast<uint32_t>(tupleSize_);
+    std::memcpy(header + 8, &count, 4);
+    std::memcpy(header + 12, &length, 4);
+    for (size_t t = 0; t < tuples_.size(); ++t) {
+        for (int k = 0; k < tupleSize_; ++k) {
+            header[24 + t * 8 + k] = static_cast<char>(tuples_[t][k]);
+        }
+    }
+    
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const char*>(weights_), static_cast<std::streamsize>(weightCount() * sizeof(float)));
+    file.close();
+    if (file.fail() || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+size_t NTupleNetwork::indexOf(uint64_t packed, const uint8_t* cells) const {
+    size_t index = 0;
+    for (int k = 0; k < tupleSize_; ++k) {
+        index |= static_cast<size_t>((packed >> (4 * cells[k])) & 0xf) << (4 * k);
+    }
+    return index;
+}
+
+float NTupleNetwork::evaluate(uint64_t packed) const {
+    float sum = 0.0f;
+    const uint8_t* cells = cells_.data();
+    for (size_t t = 0; t < tuples_.size(); ++t) {
+        const float* table = weights_ + t * tableSize_;
+        for (int s = 0; s < 8; ++s, cells += tupleSize_) {
+            sum += loadRelaxed(table + indexOf(packed, cells));
+        }
+    }
+    return sum;
+}
+
+void NTupleNetwork::update(uint64_t packed, float delta) {
+    if (!isWritable()) {
+        return;
+    }
+    const uint8_t* cells = cells_.data();
+    for (size_t t = 0; t < tuples_.size(); ++t) {
+        float* table = owned_.data() + t * tableSize_;
+        for (int s = 0; s < 8; ++s, cells += tupleSize_) {
+            float* weight = table + indexOf(packed, cells);
+            storeRelaxed(weight, loadRelaxed(weight) + delta);
+        }
+    }
+}
+
+bool NTupleNetwork::bestMove(uint64_t packed, Direction& dir, float* value) const {
+    bool found = false;
+    float best = 0.0f;
+    for (int d = 0; d < 4; ++d) {
+        int gain = 0;
+        uint64_t after = Board::movePacked(packed, static_cast<Direction>(d), &gain);
+        if (after == packed) {
+            continue;
+        }
+        float v = static_cast<float>(gain) + evaluate(after);
+        if (!found || v > best) {
+            found = true;
+            best = v;
+            dir = static_cast<Direction>(d);
+        }
+    }
+    if (found && value) {
+        *value = best;
+    }
+    return found;
+}
@@ -0,0 +1,220 @@
+#include "OpeningBook.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+const char kMagic[8] = {'2', '0', '4', '8', 'O', 'P', 'B', '1'};
+
+static_assert(sizeof(BookRecord) == 16, "BookRecord must stay 16 bytes");
+
+// 中序遍历完全二叉树，依次填入升序记录，得到层序排列（下标从1开始）
+size_t fillEytzinger(const std::vector<BookRecord>& sorted, std::vector<BookRecord>& out, size_t i, size_t k) {
+    if (k < out.size()) {
+        i = fillEytzinger(sorted, out, i, 2 * k);
+        out[k] = sorted[i++];
+        i = fillEytzinger(sorted, out, i, 2 * k + 1);
+    }
+    return i;
+}
+
+// 单个变换对方向的作用（UP=0, DOWN=1, LEFT=2, RIGHT=3）
+int mirrorDir(int d) { return d >= 2 ? d ^ 1 : d; }      // 左右互换
+int flipDir(int d) { return d < 2 ? d ^ 1 : d; }         // 上下互换
+int transposeDir(int d) { return d ^ 2; }                // 上<->左，下<->右
+
+} // namespace
+
+OpeningBook::OpeningBook()
+    : attempted_(false),
+      records_(nullptr),
+      count_(0),
+      layout_(BookLayout::SORTED),
+      plies_(0),
+      depth_(0) {
+}
+
+void OpeningBook::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    mapped_.close();
+    records_ = nullptr;
+    count_ = 0;
+    attempted_ = false;
+}
+
+void OpeningBook::ensureMapped() const {
+    if (attempted_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (attempted_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    if (!path_.empty() && mapped_.open(path_)) {
+        const char* data = mapped_.data();
+        uint32_t count, layout, plies, depth;
+        bool valid = mapped_.size() >= HEADER_SIZE && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+        if (valid) {
+            std::memcpy(&count, data + 8, 4);
+            std::memcpy(&layout, data + 12, 4);
+            std::memcpy(&plies, data + 16, 4);
+            std::memcpy(&depth, data + 20, 4);
+            // 层序排列多存一条占位记录（下标0）
+            size_t slots = layout == static_cast<uint32_t>(BookLayout::EYTZINGER) ? count + 1 : count;
+            valid = layout <= static_cast<uint32_t>(BookLayout::EYTZINGER) &&
+                    mapped_.size() == HEADER_SIZE + slots * sizeof(BookRecord);
+        }
+        if (valid) {
+            records_ = reinterpret_cast<const BookRecord*>(data + HEADER_SIZE);
+            count_ = count;
+            layout_ = static_cast<BookLayout>(layout);
+            plies_ = static_cast<int>(plies);
+            depth_ = static_cast<int>(depth);
+        } else {
+            mapped_.close();
+        }
+    }
+    attempted_.store(true, std::memory_order_release);
+}
+
+bool OpeningBook::isAvailable() const {
+    ensureMapped();
+    return records_ != nullptr;
+}
+
+size_t OpeningBook::size() const {
+    ensureMapped();
+    return count_;
+}
+
+BookLayout OpeningBook::layout() const {
+    ensureMapped();
+    return layout_;
+}
+
+int OpeningBook::plies() const {
+    ensureMapped();
+    return plies_;
+}
+
+int OpeningBook::depth() const {
+    ensureMapped();
+    return depth_;
+}
+
+bool OpeningBook::lookup(uint64_t packed, BookMove& move) const {
+    ensureMapped();
+    if (records_ == nullptr) {
+        return false;
+    }
+    
+    int symmetry;
+    uint64_t key = canonicalize(packed, symmetry);
+    const BookRecord* record = layout_ == BookLayout::EYTZINGER ? findEytzinger(key) : findSorted(key);
+    if (record == nullptr) {
+        return false;
+    }
+    move.dir = fromCanonical(static_cast<Direction>(record->dir & 3), symmetry);
+    move.value = record->value;
+    move.confidence = record->confidence;
+    move.depth = record->depth;
+    return true;
+}
+
+const BookRecord* OpeningBook::findSorted(uint64_t key) const {
+    const BookRecord* end = records_ + count_;
+    const BookRecord* it = std::lower_bound(records_, end, key,
+        [](const BookRecord& record, uint64_t k) { return record.key < k; });
+    return (it != end && it->key == key) ? it : nullptr;
+}
+
+const BookRecord* OpeningBook::findEytzinger(uint64_t key) const {
+    // 无分支下降：k 的二进制记录了每层向左还是向右；每条缓存行4条记录，预取两层之后的位置
+    size_t k = 1;
+    while (k <= count_) {
+        if (k * 4 <= count_) {
+            __builtin_prefetch(records_ + k * 4);
+        }
+        k = 2 * k + (records_[k].key < key ? 1 : 0);
+    }
+    // 去掉末尾连续的1（最后一次向左之后的右转）和那个0，得到第一个不小于 key 的位置
+    k >>= __builtin_ffsll(static_cast<long long>(~k));
+    return (k != 0 && records_[k].key == key) ? &records_[k] : nullptr;
+}
+
+bool OpeningBook::write(const std::string& path, std::vector<BookRecord> records, BookLayout layout,
+                        int plies, int depth) {
+    std::sort(records.begin(), records.end(),
+              [](const BookRecord& a, const BookRecord& b) { return a.key < b.key; });
+    
+    std::vector<BookRecord> ordered;
+    if (layout == BookLayout::EYTZINGER) {
+        ordered.assign(records.size() + 1, BookRecord());
+        fillEytzinger(records, ordered, 0, 1);
+    } else {
+        ordered.swap(records);
+    }
+    
+    char header[HEADER_SIZE] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    uint32_t count = static_cast<uint32_t>(layout == BookLayout::EYTZINGER ? ordered.size() - 1 : ordered.size());
+    uint32_t layoutValue = static_cast<uint32_t>(layout);
+    uint32_t pliesValue = static_cast<uint32_t>(plies);
+    uint32_t depthValue = static_cast<uint32_t>(depth);
+    std::memcpy(header + 8, &count, 4);
+    std::memcpy(header + 12, &layoutValue, 4);
+    std::memcpy(header + 16, &pliesValue, 4);
+    std::memcpy(header + 20, &depthValue, 4);
+    
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const char*>(ordered.data()),
+               static_cast<std::streamsize>(ordered.size() * sizeof(BookRecord)));
+    file.close();
+    if (file.fail() || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t OpeningBook::canonicalize(uint64_t packed, int& symmetry) {
+    uint64_t best = packed;
+    symmetry = 0;
+    for (int s = 1; s < 8; ++s) {
+        uint64_t board = packed;
+        if (s & 1) board = Board::mirror(board);
+        if (s & 2) board = Board::flip(board);
+        if (s & 4) board = Board::transpose(board);
+        if (board < best) {
+            best = board;
+            symmetry = s;
+        }
+    }
+    return best;
+}
+
+Direction OpeningBook::toCanonical(Direction dir, int symmetry) {
+    int d = static_cast<int>(dir);
+    if (symmetry & 1) d = mirrorDir(d);
+    if (symmetry & 2) d = flipDir(d);
+    if (symmetry & 4) d = transposeDir(d);
+    return static_cast<Direction>(d);
+}
+
+Direction OpeningBook::fromCanonical(Direction dir, int symmetry) {
+    // 逆变换按相反顺序作用（每个变换都是自己的逆）
+    int d = static_cast<int>(dir);
+    if (symmetry & 4) d = transposeDir(d);
+    if (symmetry & 2) d = flipDir(d);
+    if (symmetry & 1) d = mirrorDir(d);
+    return static_cast<Direction>(d);
+}
@@ -0,0 +1,223 @@
+#include "PeriodRanks.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// 汇总最多保留的条数（两周日榜 + 两个月周榜）
+const size_t kDailyRollups = 14;
+const size_t kWeeklyRollups = 8;
+
+} // namespace
+
+PeriodRanks::PeriodRanks() {
+    daily_.kind = 'D';
+    daily_.periodId = -1;
+    weekly_.kind = 'W';
+    weekly_.periodId = -1;
+}
+
+long PeriodRanks::dayOf(int64_t timestamp) {
+    std::time_t t = static_cast<std::time_t>(timestamp);
+    std::tm local;
+    localtime_r(&t, &local);
+    int64_t localSeconds = timestamp + local.tm_gmtoff;
+    return static_cast<long>(localSeconds >= 0 ? localSeconds / 86400 : (localSeconds - 86399) / 86400);
+}
+
+long PeriodRanks::weekOf(int64_t timestamp) {
+    // 1970-01-01 是周四，偏移3天让每周从周一开始
+    return (dayOf(timestamp) + 3) / 7;
+}
+
+void PeriodRanks::Board::upsert(const std::string& name, int score, int64_t timestamp) {
+    auto it = byName.find(name);
+    if (it != byName.end()) {
+        if (score <= it->second.first) {
+            return;
+        }
+        ordered.erase(std::make_tuple(-it->second.first, it->second.second, name));
+        it->second = {score, timestamp};
+    } else {
+        byName.emplace(name, std::make_pair(score, timestamp));
+    }
+    ordered.emplace(-score, timestamp, name);
+}
+
+void PeriodRanks::Board::reset(long id) {
+    periodId = id;
+    byName.clear();
+    ordered.clear();
+}
+
+void PeriodRanks::record(const std::string& username, int score, int64_t timestamp) {
+    advance(timestamp);
+    if (dayOf(timestamp) == daily_.periodId) {
+        daily_.upsert(username, score, timestamp);
+    }
+    if (weekOf(timestamp) == weekly_.periodId) {
+        weekly_.upsert(username, score, timestamp);
+    }
+}
+
+bool PeriodRanks::advance(int64_t now) {
+    bool rolled = false;
+    
+    // 只向前推进：时钟回拨时保持当前时段
+    long day = dayOf(now);
+    if (daily_.periodId < day) {
+        rolled |= !daily_.byName.empty();
+        rollUp(daily_);
+        daily_.reset(day);
+    }
+    
+    long week = weekOf(now);
+    if (weekly_.periodId < week) {
+        rolled |= !weekly_.byName.empty();
+        rollUp(weekly_);
+        weekly_.reset(week);
+    }
+    
+    return rolled;
+}
+
+std::vector<std::pair<std::string, int>> PeriodRanks::top(RankPeriod period, size_t n) const {
+    std::vector<std::pair<std::string, int>> result;
+    if (period == RankPeriod::ALL_TIME) {
+        return result;
+    }
+    
+    const Board& board = period == RankPeriod::DAILY ? daily_ : weekly_;
+    for (auto it = board.ordered.begin(); it != board.ordered.end() && result.size() < n; ++it) {
+        result.push_back({std::get<2>(*it), -std::get<0>(*it)});
+    }
+    return result;
+}
+
+void PeriodRanks::rollUp(Board& board) {
+    if (board.ordered.empty()) {
+        return;
+    }
+    
+    const auto& best = *board.ordered.begin();
+    addRollup({board.kind, board.periodId, static_cast<uint32_t>(board.byName.size()),
+               -std::get<0>(best), std::get<2>(best)});
+}
+
+void PeriodRanks::addRollup(const PeriodRollup& rollup) {
+    // 同一时段已有汇总（其他进程写过）则取较大值
+    for (auto& existing : rollups_) {
+        if (existing.kind == rollup.kind && existing.periodId == rollup.periodId) {
+            existing.players = std::max(existing.players, rollup.players);
+            if (rollup.topScore > existing.topScore) {
+                existing.topScore = rollup.topScore;
+                existing.topName = rollup.topName;
+            }
+            return;
+        }
+    }
+    
+    rollups_.push_back(rollup);
+    std::sort(rollups_.begin(), rollups_.end(), [](const PeriodRollup& a, const PeriodRollup& b) {
+        if (a.kind != b.kind) return a.kind < b.kind;
+        return a.periodId > b.periodId;
+    });
+    
+    // 每类只保留最近若干条
+    size_t daily = 0, weekly = 0;
+    rollups_.erase(std::remove_if(rollups_.begin(), rollups_.end(), [&](const PeriodRollup& r) {
+        return r.kind == 'D' ? ++daily > kDailyRollups : ++weekly > kWeeklyRollups;
+    }), rollups_.end());
+}
+
+bool PeriodRanks::mergeFrom(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // 行格式：
+    //   D <日编号> <用户名> <分数> <时间>
+    //   W <周编号> <用户名> <分数> <时间>
+    //   R <D|W> <编号> <人数> <最高分> <用户名>
+    // 比当前时段更早的榜单（写入方还没来得及压缩）先收集起来，最后压缩为汇总
+    std::map<std::pair<char, long>, Board> stale;
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        char kind;
+        if (!(in >> kind)) {
+            continue;
+        }
+        
+        if (kind == 'R') {
+            PeriodRollup rollup;
+            if (in >> rollup.kind >> rollup.periodId >> rollup.players >> rollup.topScore >> rollup.topName) {
+                addRollup(rollup);
+            }
+            continue;
+        }
+        
+        long periodId;
+        std::string name;
+        int score;
+        int64_t timestamp;
+        if (!(in >> periodId >> name >> score >> timestamp)) {
+            continue;
+        }
+        
+        if (kind != 'D' && kind != 'W') {
+            continue;
+        }
+        
+        Board& board = kind == 'D' ? daily_ : weekly_;
+        if (periodId > board.periodId) {
+            rollUp(board);
+            board.reset(periodId);
+        }
+        if (periodId == board.periodId) {
+            board.upsert(name, score, timestamp);
+        } else {
+            Board& old = stale[{kind, periodId}];
+            old.kind = kind;
+            old.periodId = periodId;
+            old.upsert(name, score, timestamp);
+        }
+    }
+    
+    for (auto& entry : stale) {
+        rollUp(entry.second);
+    }
+    
+    return true;
+}
+
+bool PeriodRanks::saveTo(const std::string& path) const {
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    for (const Board* board : {&daily_, &weekly_}) {
+        for (const auto& entry : board->byName) {
+            file << board->kind << " " << board->periodId << " " << entry.first << " "
+                 << entry.second.first << " " << entry.second.second << "\n";
+        }
+    }
+    for (const auto& rollup : rollups_) {
+        file << "R " << rollup.kind << " " << rollup.periodId << " " << rollup.players << " "
+             << rollup.topScore << " " << rollup.topName << "\n";
+    }
+    
+    file.close();
+    if (file.fail() || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,329 @@
+#include "PlayerStats.h"
+#include "FileLock.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char kMagic[8] = {'2', '0', '4', '8', 'S', 'T', 'A', 'T'};
+const uint32_t kVersion = 1;
+const uint32_t kInitialCapacity = 64;
+
+// 列的排列顺序与宽度（8字节列在前，保证对齐）
+const size_t kColumnWidths[] = {8, 8, 4, 4, 4};
+const size_t kColumnCount = sizeof(kColumnWidths) / sizeof(kColumnWidths[0]);
+
+size_t columnOffset(size_t column, uint32_t capacity) {
+    size_t offset = 64;
+    for (size_t i = 0; i < column; ++i) {
+        offset += kColumnWidths[i] * capacity;
+    }
+    return offset;
+}
+
+int tileLog2(uint32_t tile) {
+    int log = 0;
+    while (tile > 1) {
+        tile >>= 1;
+        ++log;
+    }
+    return log;
+}
+
+} // namespace
+
+PlayerStats::PlayerStats(const std::string& filePath)
+    : filePath_(filePath), fd_(-1), data_(nullptr), mappedSize_(0), mappedInode_(0),
+      header_(nullptr), totalScore_(nullptr), totalMoves_(nullptr),
+      games_(nullptr), bestScore_(nullptr), maxTile_(nullptr), namesBytes_(0) {
+}
+
+PlayerStats::~PlayerStats() {
+    unmapFile();
+}
+
+std::string PlayerStats::namesFilePath() const {
+    return filePath_ + ".names";
+}
+
+std::string PlayerStats::lockFilePath() const {
+    return filePath_ + ".lock";
+}
+
+size_t PlayerStats::fileSizeFor(uint32_t capacity) {
+    return columnOffset(kColumnCount, capacity);
+}
+
+bool PlayerStats::open() {
+    FileLock lock(lockFilePath(), true);
+    
+    struct stat st;
+    bool valid = stat(filePath_.c_str(), &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header);
+    if (!valid && !createUnlocked(kInitialCapacity)) {
+        return false;
+    }
+    
+    names_.clear();
+    namesBytes_ = 0;
+    if (!mapFile()) {
+        return false;
+    }
+    
+    // 文件头损坏（或版本不符）则重建为空文件
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 || header_->version != kVersion) {
+        unmapFile();
+        std::remove(namesFilePath().c_str());
+        if (!createUnlocked(kInitialCapacity) || !mapFile()) {
+            return false;
+        }
+    }
+    
+    return syncUnlocked();
+}
+
+bool PlayerStats::createUnlocked(uint32_t capacity) {
+    std::string tmpPath = filePath_ + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.capacity = capacity;
+    
+    // ftruncate 扩展的部分全部为0，即所有列的初始值
+    bool ok = ::write(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header)) &&
+              ftruncate(fd, static_cast<off_t>(fileSizeFor(capacity))) == 0;
+    ::close(fd);
+    
+    if (!ok || std::rename(tmpPath.c_str(), filePath_.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    
+    // 新文件没有玩家，旧的 names 文件随之作废
+    ::truncate(namesFilePath().c_str(), 0);
+    return true;
+}
+
+bool PlayerStats::mapFile() {
+    unmapFile();
+    
+    fd_ = ::open(filePath_.c_str(), O_RDWR);
+    if (fd_ < 0) {
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        unmapFile();
+        return false;
+    }
+    
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        unmapFile();
+        return false;
+    }
+    
+    data_ = addr;
+    mappedSize_ = static_cast<size_t>(st.st_size);
+    mappedInode_ = static_cast<unsigned long long>(st.st_ino);
+    header_ = static_cast<Header*>(data_);
+    
+    // 容量与文件大小不符（截断的文件）时不设置列指针
+    uint32_t capacity = header_->capacity;
+    if (fileSizeFor(capacity) > mappedSize_) {
+        unmapFile();
+        return false;
+    }
+    
+    char* base = static_cast<char*>(data_);
+    totalScore_ = reinterpret_cast<uint64_t*>(base + columnOffset(0, capacity));
+    totalMoves_ = reinterpret_cast<uint64_t*>(base + columnOffset(1, capacity));
+    games_ = reinterpret_cast<uint32_t*>(base + columnOffset(2, capacity));
+    bestScore_ = reinterpret_cast<uint32_t*>(base + columnOffset(3, capacity));
+    maxTile_ = reinterpret_cast<uint32_t*>(base + columnOffset(4, capacity));
+    return true;
+}
+
+void PlayerStats::unmapFile() {
+    if (data_ != nullptr) {
+        munmap(data_, mappedSize_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    mappedSize_ = 0;
+    mappedInode_ = 0;
+    header_ = nullptr;
+    totalScore_ = totalMoves_ = nullptr;
+    games_ = bestScore_ = maxTile_ = nullptr;
+}
+
+bool PlayerStats::syncUnlocked() {
+    // 其他进程扩容后文件被替换：重新映射
+    struct stat st;
+    if (stat(filePath_.c_str(), &st) != 0) {
+        return false;
+    }
+    if (data_ == nullptr || static_cast<unsigned long long>(st.st_ino) != mappedInode_) {
+        if (!mapFile()) {
+            return false;
+        }
+    }
+    
+    // 其他进程新增了玩家：读取 names 文件新增的行（只读到头部记录的人数为止）
+    uint32_t count = header_->count;
+    if (names_.size() < count) {
+        std::ifstream file(namesFilePath(), std::ios::binary);
+        file.seekg(namesBytes_);
+        std::string name;
+        while (names_.size() < count && std::getline(file, name)) {
+            namesBytes_ += static_cast<long long>(name.size()) + 1;
+            names_.intern(name);
+        }
+        if (names_.size() < count) {
+            return false;  // names 文件不完整
+        }
+    }
+    
+    return true;
+}
+
+bool PlayerStats::growUnlocked(uint32_t capacity) {
+    std::string tmpPath = filePath_ + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    // 按新容量的布局逐列复制（每列后面补0）
+    uint32_t oldCapacity = header_->capacity;
+    std::vector<char> buffer(fileSizeFor(capacity), 0);
+    std::memcpy(buffer.data(), header_, sizeof(Header));
+    reinterpret_cast<Header*>(buffer.data())->capacity = capacity;
+    
+    const char* base = static_cast<const char*>(data_);
+    for (size_t column = 0; column < kColumnCount; ++column) {
+        std::memcpy(buffer.data() + columnOffset(column, capacity),
+                    base + columnOffset(column, oldCapacity),
+                    kColumnWidths[column] * oldCapacity);
+    }
+    
+    bool ok = ::write(fd, buffer.data(), buffer.size()) == static_cast<ssize_t>(buffer.size());
+    ::close(fd);
+    
+    if (!ok || std::rename(tmpPath.c_str(), filePath_.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    
+    return mapFile();
+}
+
+bool PlayerStats::recordGame(const std::string& username, int score, int maxTile, int moves) {
+    FileLock lock(lockFilePath(), true);
+    if (!syncUnlocked()) {
+        return false;
+    }
+    
+    uint32_t id = names_.find(username);
+    if (id == StringPool::npos) {
+        // 新玩家：必要时扩容，再追加用户名，最后才增加人数（中途崩溃不会留下错位的id）
+        uint32_t count = header_->count;
+        if (count == header_->capacity && !growUnlocked(header_->capacity * 2)) {
+            return false;
+        }
+        
+        int fd = ::open(namesFilePath().c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        std::string line = username + "\n";
+        bool ok = ftruncate(fd, static_cast<off_t>(namesBytes_)) == 0 &&
+                  lseek(fd, 0, SEEK_END) == static_cast<off_t>(namesBytes_) &&
+                  ::write(fd, line.data(), line.size()) == static_cast<ssize_t>(line.size());
+        ::close(fd);
+        if (!ok) {
+            return false;
+        }
+        
+        namesBytes_ += static_cast<long long>(line.size());
+        id = names_.intern(username);
+        header_->count = count + 1;
+    }
+    
+    // 只改写该玩家在各列中的一个元素
+    games_[id] += 1;
+    totalScore_[id] += static_cast<uint64_t>(std::max(score, 0));
+    totalMoves_[id] += static_cast<uint64_t>(std::max(moves, 0));
+    bestScore_[id] = std::max(bestScore_[id], static_cast<uint32_t>(std::max(score, 0)));
+    maxTile_[id] = std::max(maxTile_[id], static_cast<uint32_t>(std::max(maxTile, 0)));
+    return true;
+}
+
+bool PlayerStats::get(const std::string& username, PlayerStatRow& out) {
+    FileLock lock(lockFilePath(), false);
+    if (!syncUnlocked()) {
+        return false;
+    }
+    
+    uint32_t id = names_.find(username);
+    if (id == StringPool::npos) {
+        return false;
+    }
+    
+    out.username = names_.get(id);
+    out.gamesPlayed = games_[id];
+    out.totalScore = totalScore_[id];
+    out.bestScore = bestScore_[id];
+    out.maxTile = maxTile_[id];
+    out.totalMoves = totalMoves_[id];
+    return true;
+}
+
+PlayerStatSummary PlayerStats::summarize() {
+    PlayerStatSummary summary;
+    FileLock lock(lockFilePath(), false);
+    if (!syncUnlocked()) {
+        return summary;
+    }
+    
+    // 每个指标是一段连续数组，顺序扫描即可
+    uint32_t count = header_->count;
+    summary.players = count;
+    for (uint32_t i = 0; i < count; ++i) {
+        summary.gamesPlayed += games_[i];
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        summary.totalScore += totalScore_[i];
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        summary.totalMoves += totalMoves_[i];
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        summary.maxTile = std::max(summary.maxTile, maxTile_[i]);
+        int log = std::min(tileLog2(maxTile_[i]), 17);
+        ++summary.playersByMaxTile[log];
+    }
+    return summary;
+}
+
+size_t PlayerStats::size() {
+    FileLock lock(lockFilePath(), false);
+    syncUnlocked();
+    return names_.size();
+}
@@ -0,0 +1,27 @@
+#include "Policy.h"
+#include "HintSearch.h"
+
+SearchPolicy::SearchPolicy(int depth, const NTupleNetwork* network)
+    : depth_(depth < 1 ? 1 : depth),
+      network_(network),
+      name_("search d" + std::to_string(depth_) + (network ? " n-tuple" : "")) {
+}
+
+bool SearchPolicy::choose(uint64_t packed, Direction& dir) {
+    Hint hint;
+    if (!HintSearch::search(packed, depth_, network_, hint)) {
+        return false;
+    }
+    dir = hint.dir;
+    return true;
+}
+
+AnyPolicy makePolicy(const std::string& name, const NTupleNetwork* network) {
+    if (name == "greedy") return GreedyPolicy();
+    if (name == "corner") return CornerPolicy();
+    if (name == "random") return RandomPolicy();
+    if (name == "search") return SearchPolicy(2, network);
+    if (name == "search3") return SearchPolicy(3, network);
+    if (name == "ntuple" && network != nullptr && network->isReady()) return NTuplePolicy(*network);
+    return AnyPolicy();
+}
@@ -0,0 +1,143 @@
+#include "PrefixIndex.h"
+#include <algorithm>
+#include <queue>
+
+namespace {
+
+char foldCase(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// 忽略ASCII大小写的字典序比较
+int compareFolded(std::string_view a, std::string_view b) {
+    size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char ca = static_cast<unsigned char>(foldCase(a[i]));
+        unsigned char cb = static_cast<unsigned char>(foldCase(b[i]));
+        if (ca != cb) {
+            return ca < cb ? -1 : 1;
+        }
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+const uint32_t kNone = 0xFFFFFFFFu;
+
+// 取折叠大小写后的前8字节按大端拼成整数，排序时先比它，相同再比完整字符串
+uint64_t foldedKey(std::string_view str) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        key <<= 8;
+        if (i < str.size()) {
+            key |= static_cast<unsigned char>(foldCase(str[i]));
+        }
+    }
+    return key;
+}
+
+} // namespace
+
+PrefixIndex::PrefixIndex() : leaves_(0) {
+}
+
+void PrefixIndex::build(std::shared_ptr<const RankSnapshot> snapshot) {
+    snapshot_ = std::move(snapshot);
+    snapshot_->getPage(0, snapshot_->size(), entries_);
+    
+    std::vector<std::pair<uint64_t, RankEntryView>> keyed;
+    keyed.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        keyed.push_back({foldedKey(entry.username), entry});
+    }
+    
+    std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        return compareFolded(a.second.username, b.second.username) < 0;
+    });
+    
+    for (size_t i = 0; i < keyed.size(); ++i) {
+        entries_[i] = keyed[i].second;
+    }
+    
+    // 自底向上构建最大值线段树
+    leaves_ = 1;
+    while (leaves_ < entries_.size()) {
+        leaves_ *= 2;
+    }
+    tree_.assign(leaves_ * 2, kNone);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        tree_[leaves_ + i] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = leaves_ - 1; i > 0; --i) {
+        tree_[i] = better(tree_[i * 2], tree_[i * 2 + 1]);
+    }
+}
+
+uint64_t PrefixIndex::version() const {
+    return snapshot_ ? snapshot_->version() : 0;
+}
+
+size_t PrefixIndex::complete(std::string_view prefix, size_t k, std::vector<RankEntryView>& out) const {
+    out.clear();
+    if (entries_.empty() || k == 0) {
+        return 0;
+    }
+    
+    // 二分定位前缀区间 [lo, hi)
+    auto lo = std::lower_bound(entries_.begin(), entries_.end(), prefix,
+        [](const RankEntryView& e, std::string_view p) { return compareFolded(e.username, p) < 0; });
+    auto hi = std::upper_bound(lo, entries_.end(), prefix,
+        [](std::string_view p, const RankEntryView& e) {
+            return compareFolded(p, e.username.substr(0, p.size())) < 0;
+        });
+    
+    // 每次取出区间最大值，再把左右两段放回堆中
+    struct Range {
+        size_t lo, hi;
+        uint32_t best;
+    };
+    auto cmp = [this](const Range& a, const Range& b) { return better(a.best, b.best) != a.best; };
+    std::priority_queue<Range, std::vector<Range>, decltype(cmp)> heap(cmp);
+    
+    size_t first = static_cast<size_t>(lo - entries_.begin());
+    size_t last = static_cast<size_t>(hi - entries_.begin());
+    if (first < last) {
+        heap.push({first, last, maxIn(first, last)});
+    }
+    
+    while (!heap.empty() && out.size() < k) {
+        Range range = heap.top();
+        heap.pop();
+        out.push_back(entries_[range.best]);
+        
+        if (range.lo < range.best) {
+            heap.push({range.lo, range.best, maxIn(range.lo, range.best)});
+        }
+        if (range.best + 1 < range.hi) {
+            heap.push({range.best + 1, range.hi, maxIn(range.best + 1, range.hi)});
+        }
+    }
+    
+    return out.size();
+}
+
+uint32_t PrefixIndex::maxIn(size_t lo, size_t hi) const {
+    uint32_t result = kNone;
+    for (lo += leaves_, hi += leaves_; lo < hi; lo /= 2, hi /= 2) {
+        if (lo & 1) result = better(result, tree_[lo++]);
+        if (hi & 1) result = better(result, tree_[--hi]);
+    }
+    return result;
+}
+
+uint32_t PrefixIndex::better(uint32_t a, uint32_t b) const {
+    if (a == kNone) return b;
+    if (b == kNone) return a;
+    // 分数高者优先，同分取名次靠前者
+    if (entries_[a].score != entries_[b].score) {
+        return entries_[a].score > entries_[b].score ? a : b;
+    }
+    return entries_[a].rank < entries_[b].rank ? a : b;
+}
@@ -1,163 +1,823 @@
 #include "RankList.h"
-#include <fstream>
+#include "MappedFile.h"
+#include "FileLock.h"
 #include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <ctime>
 
 RankList::RankList(const std::string& rankFilePath) 
-    : head_(nullptr), rankFilePath_(rankFilePath) {
+    : snapshot_(std::make_shared<const RankSnapshot>()), version_(0), dirty_(false), rebuildChunks_(false),
+      head_(-1), freeHead_(-1), rankFilePath_(rankFilePath), count_(0), recentDays_(7),
+      periodsDirty_(false), periodTopStale_(true),
+      logEntries_(0), rewritePending_(false), syncedLogSize_(0) {
 }
 
 RankList::~RankList() {
-    clear();
+}
+
+namespace {
+
+// 更新日志超过该条数且超过记录数的一半时才压缩
+const size_t kMinCompactEntries = 256;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// 逐条解析 "用户名 分数 [时间]" 记录，遇到格式错误即停止（与原 file >> 行为一致）
+// 时间列可选（旧文件没有），只在同一行内查找，缺省为0
+template <typename Fn>
+size_t parseRecords(const char* p, const char* end, Fn&& onRecord) {
+    size_t parsed = 0;
+    
+    while (true) {
+        while (p < end && isSpace(*p)) ++p;
+        const char* nameBegin = p;
+        while (p < end && !isSpace(*p)) ++p;
+        if (p == nameBegin) break;
+        std::string_view name(nameBegin, static_cast<size_t>(p - nameBegin));
+        
+        while (p < end && isSpace(*p)) ++p;
+        int score = 0;
+        auto res = std::from_chars(p, end, score);
+        if (res.ec != std::errc()) break;
+        p = res.ptr;
+        
+        int64_t timestamp = 0;
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        if (p < end && *p >= '0' && *p <= '9') {
+            auto tsRes = std::from_chars(p, end, timestamp);
+            p = tsRes.ptr;
+        }
+        
+        onRecord(name, score, timestamp);
+        ++parsed;
+    }
+    
+    return parsed;
+}
+
+} // namespace
+
+RankList::FileStamp RankList::FileStamp::of(const std::string& path) {
+    FileStamp stamp;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) {
+        stamp.inode = static_cast<unsigned long long>(st.st_ino);
+        stamp.size = static_cast<long long>(st.st_size);
+        stamp.mtime = static_cast<long long>(st.st_mtime);
+    }
+    return stamp;
+}
+
+std::string RankList::logFilePath() const {
+    return rankFilePath_ + ".log";
+}
+
+std::string RankList::lockFilePath() const {
+    return rankFilePath_ + ".lock";
+}
+
+std::string RankList::periodFilePath() const {
+    return rankFilePath_ + ".periods";
 }
 
 void RankList::load() {
-    clear();
+    std::lock_guard<std::mutex> guard(mutex_);
+    FileLock lock(lockFilePath(), false);
+    pendingLog_.clear();
+    periods_ = PeriodRanks();
+    periodsDirty_ = false;
+    loadUnlocked();
+    publishIfDirty();
+}
+
+void RankList::loadUnlocked() {
+    clearUnlocked();
+    rewritePending_ = false;
+    logEntries_ = 0;
     
-    std::ifstream file(rankFilePath_);
-    if (!file.is_open()) {
+    // 先记录文件标识再读取：持有共享锁期间不会有写者，两者一致
+    syncedMain_ = FileStamp::of(rankFilePath_);
+    syncedLogSize_ = 0;
+    
+    MappedFile mainFile;
+    MappedFile logFile;
+    bool hasMain = mainFile.open(rankFilePath_);
+    bool hasLog = logFile.open(logFilePath());
+    
+    // 按行数一次性预留，整个加载过程不再扩容
+    size_t bytes = 0;
+    size_t estimate = 1;
+    for (const MappedFile* file : {&mainFile, &logFile}) {
+        if (file->isOpen()) {
+            bytes += file->size();
+            estimate += static_cast<size_t>(std::count(file->data(), file->data() + file->size(), '\n'));
+        }
+    }
+    names_.reserve(estimate, bytes);
+    
+    // 用户名直接驻留进字符串池去重；entryOfName 记录每个名字在 entries 中的位置
+    struct LoadedEntry {
+        uint32_t nameId;
+        int score;
+        int64_t timestamp;
+    };
+    std::vector<LoadedEntry> entries;
+    std::vector<int32_t> entryOfName;
+    entries.reserve(estimate);
+    entryOfName.reserve(estimate);
+    
+    // 合并规则：分数取最大值，负数（删除标记）直接覆盖
+    auto apply = [&](std::string_view name, int score, int64_t timestamp) {
+        uint32_t id = names_.intern(name);
+        if (id == entryOfName.size()) {
+            entryOfName.push_back(-1);
+        }
+        
+        int32_t pos = entryOfName[id];
+        if (pos < 0) {
+            if (score >= 0) {
+                entryOfName[id] = static_cast<int32_t>(entries.size());
+                entries.push_back({id, score, timestamp});
+            }
+        } else if (score < 0 || score > entries[pos].score) {
+            entries[pos].score = score;
+            entries[pos].timestamp = timestamp;
+        }
+    };
+    
+    if (hasMain) {
+        parseRecords(mainFile.data(), mainFile.data() + mainFile.size(), apply);
+    }
+    
+    // 回放更新日志：每条记录是该用户变更后的分数，负数表示删除
+    if (hasLog) {
+        logEntries_ = parseRecords(logFile.data(), logFile.data() + logFile.size(), apply);
+        syncedLogSize_ = static_cast<long long>(logFile.size());
+    }
+    
+    // 批量建表：稳定排序（同分保持文件顺序）后按名次顺序连续写入节点池，O(n log n)
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const auto& a, const auto& b) { return a.score > b.score; });
+    
+    nodes_.reserve(entries.size());
+    nodeOfName_.assign(names_.size(), -1);
+    
+    int32_t* tail = &head_;
+    for (const auto& entry : entries) {
+        if (entry.score < 0) continue;  // 已删除
+        int32_t node = static_cast<int32_t>(nodes_.size());
+        nodes_.push_back({entry.nameId, entry.score, -1, entry.timestamp});
+        nodeOfName_[entry.nameId] = node;
+        bestScores_.add(entry.score);
+        *tail = node;
+        tail = &nodes_.back().next;
+        ++count_;
+    }
+    dirty_ = true;
+    rebuildChunks_ = true;
+    
+    // 时段榜单按最大值合并，不会丢失本地尚未落盘的记录
+    syncedPeriods_ = FileStamp();
+    mergePeriodsUnlocked();
+}
+
+bool RankList::refreshIfChanged() {
+    // 由逻辑线程每秒调用：有写者正在工作就直接跳过，下次再查
+    std::unique_lock<std::mutex> guard(mutex_, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        return false;
+    }
+    
+    // 跨过日/周边界时把过期榜单压缩为汇总，下次保存时落盘
+    if (periods_.advance(static_cast<int64_t>(std::time(nullptr)))) {
+        periodsDirty_ = true;
+        periodTopStale_ = true;
+        dirty_ = true;
+    }
+    
+    // 只做三次stat：文件未变时开销可忽略，可以每帧调用
+    bool changed = false;
+    if (!(FileStamp::of(rankFilePath_) == syncedMain_) ||
+        std::max(FileStamp::of(logFilePath()).size, 0LL) != syncedLogSize_ ||
+        !(FileStamp::of(periodFilePath()) == syncedPeriods_)) {
+        FileLock lock(lockFilePath(), false);
+        changed = catchUpUnlocked();
+    }
+    
+    publishIfDirty();
+    return changed;
+}
+
+bool RankList::mergePeriodsUnlocked() {
+    FileStamp stamp = FileStamp::of(periodFilePath());
+    if (stamp == syncedPeriods_) {
+        return false;
+    }
+    
+    syncedPeriods_ = stamp;
+    if (!periods_.mergeFrom(periodFilePath())) {
+        return false;
+    }
+    periods_.advance(static_cast<int64_t>(std::time(nullptr)));
+    periodTopStale_ = true;
+    dirty_ = true;
+    return true;
+}
+
+void RankList::savePeriodsUnlocked() {
+    if (!periodsDirty_) {
         return;
     }
     
-    std::string username;
-    int score;
+    if (periods_.saveTo(periodFilePath())) {
+        periodsDirty_ = false;
+        syncedPeriods_ = FileStamp::of(periodFilePath());
+    }
+}
+
+bool RankList::catchUpUnlocked() {
+    bool periodsChanged = mergePeriodsUnlocked();
+    
+    FileStamp mainStamp = FileStamp::of(rankFilePath_);
+    long long logSize = std::max(FileStamp::of(logFilePath()).size, 0LL);
     
-    while (file >> username >> score) {
-        RankNode* node = new RankNode(username, score);
-        insertNode(node);
+    if (mainStamp == syncedMain_ && logSize == syncedLogSize_) {
+        return periodsChanged;
     }
     
-    file.close();
+    if (mainStamp == syncedMain_ && logSize > syncedLogSize_) {
+        // 只有日志增长：读取新增的尾部并合并
+        std::ifstream file(logFilePath(), std::ios::binary);
+        std::string tail(static_cast<size_t>(logSize - syncedLogSize_), '\0');
+        file.seekg(syncedLogSize_);
+        if (file.read(&tail[0], static_cast<std::streamsize>(tail.size()))) {
+            logEntries_ += parseRecords(tail.data(), tail.data() + tail.size(),
+                [this](std::string_view name, int score, int64_t timestamp) {
+                    mergeRecord(name, score, timestamp);
+                });
+            syncedLogSize_ = logSize;
+            return true;
+        }
+    }
+    
+    // 主文件被其他进程压缩替换：整体重新加载，再把本地未落盘的变更合并回去
+    std::vector<std::pair<std::string, PendingRecord>> pending;
+    pending.reserve(pendingLog_.size());
+    for (const auto& entry : pendingLog_) {
+        pending.push_back({std::string(names_.get(entry.nameId)), entry});
+    }
+    
+    loadUnlocked();
+    
+    for (auto& entry : pending) {
+        mergeRecord(entry.first, entry.second.score, entry.second.timestamp);
+        entry.second.nameId = names_.intern(entry.first);
+        pendingLog_.push_back(entry.second);
+    }
+    return true;
+}
+
+void RankList::mergeRecord(std::string_view name, int score, int64_t timestamp) {
+    if (score < 0) {
+        uint32_t nameId = names_.find(name);
+        if (nameId != StringPool::npos) {
+            removeNode(nameId);
+        }
+    } else {
+        upsertMax(names_.intern(name), score, timestamp);
+    }
 }
 
 void RankList::save() {
-    std::ofstream file(rankFilePath_);
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (pendingLog_.empty() && !rewritePending_ && !periodsDirty_) {
+        return;
+    }
+    
+    // 加锁的 读取-合并-写入：先并入其他进程的更新，再追加本地变更
+    FileLock lock(lockFilePath(), true);
+    
+    if (rewritePending_) {
+        savePeriodsUnlocked();
+        compactUnlocked();
+        return;
+    }
+    
+    catchUpUnlocked();
+    publishIfDirty();
+    savePeriodsUnlocked();
+    
+    if (pendingLog_.empty()) {
+        return;
+    }
+    
+    if (logEntries_ + pendingLog_.size() > std::max(kMinCompactEntries, count_ / 2)) {
+        compactUnlocked();
+        return;
+    }
+    
+    // 一次write追加整批记录（O_APPEND），日志记录的合并是幂等的
+    std::string batch;
+    for (const auto& entry : pendingLog_) {
+        batch.append(names_.get(entry.nameId));
+        batch += ' ';
+        batch += std::to_string(entry.score);
+        batch += ' ';
+        batch += std::to_string(entry.timestamp);
+        batch += '\n';
+    }
+    
+    int fd = ::open(logFilePath().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return;
+    }
+    
+    bool ok = ::write(fd, batch.data(), batch.size()) == static_cast<ssize_t>(batch.size());
+    ::close(fd);
+    
+    if (ok) {
+        logEntries_ += pendingLog_.size();
+        syncedLogSize_ += static_cast<long long>(batch.size());
+        pendingLog_.clear();
+    }
+}
+
+void RankList::compact() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    FileLock lock(lockFilePath(), true);
+    if (!rewritePending_) {
+        catchUpUnlocked();
+        publishIfDirty();
+    }
+    savePeriodsUnlocked();
+    compactUnlocked();
+}
+
+void RankList::compactUnlocked() {
+    // 先写临时文件再原子替换，避免中途崩溃或其他进程读到半截排行榜
+    std::string tmpPath = rankFilePath_ + ".tmp";
+    std::ofstream file(tmpPath, std::ios::trunc);
     if (!file.is_open()) {
         return;
     }
     
-    RankNode* current = head_;
-    while (current != nullptr) {
-        file << current->username << " " << current->score << "\n";
-        current = current->next;
+    for (int32_t current = head_; current != -1; current = nodes_[current].next) {
+        file << names_.get(nodes_[current].nameId) << " " << nodes_[current].score << " "
+             << nodes_[current].timestamp << "\n";
     }
     
     file.close();
+    if (file.fail() || std::rename(tmpPath.c_str(), rankFilePath_.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return;
+    }
+    
+    std::remove(logFilePath().c_str());
+    logEntries_ = 0;
+    pendingLog_.clear();
+    rewritePending_ = false;
+    syncedMain_ = FileStamp::of(rankFilePath_);
+    syncedLogSize_ = 0;
 }
 
 void RankList::insertOrUpdate(const std::string& username, int score) {
-    // 查找是否已存在该用户
-    RankNode* existing = findNode(username);
-    
-    if (existing != nullptr) {
-        // 用户已存在
-        if (score > existing->score) {
-            // 新分数更高，删除旧记录并插入新记录
-            remove(username);
-            RankNode* newNode = new RankNode(username, score);
-            insertNode(newNode);
-        }
-        // 否则不更新（保留旧的更高分数）
-    } else {
-        // 新用户，直接插入
-        RankNode* newNode = new RankNode(username, score);
-        insertNode(newNode);
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint32_t nameId = names_.intern(username);
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    
+    recordGame(score);
+    periods_.record(username, score, now);
+    periodsDirty_ = true;
+    periodTopStale_ = true;
+    dirty_ = true;
+    
+    // 新用户直接插入；已存在且新分数更高才更新（保留旧的更高分数）
+    if (upsertMax(nameId, score, now)) {
+        pendingLog_.push_back({nameId, score, now});
     }
+    publishIfDirty();
+}
+
+void RankList::insertOrUpdateBatch(const std::vector<std::pair<std::string, int>>& entries) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    for (const auto& entry : entries) {
+        uint32_t nameId = names_.intern(entry.first);
+        recordGame(entry.second);
+        periods_.record(entry.first, entry.second, now);
+        if (upsertMax(nameId, entry.second, now)) {
+            pendingLog_.push_back({nameId, entry.second, now});
+        }
+    }
+    periodsDirty_ = periodsDirty_ || !entries.empty();
+    periodTopStale_ = true;
+    dirty_ = true;
+    publishIfDirty();
+}
+
+bool RankList::upsertMax(uint32_t nameId, int score, int64_t timestamp) {
+    if (nameId >= nodeOfName_.size()) {
+        nodeOfName_.resize(nameId + 1, -1);
+    }
+    
+    int32_t existing = findNode(nameId);
+    if (existing != -1) {
+        if (score <= nodes_[existing].score) {
+            return false;
+        }
+        // 新分数更高，删除旧记录并插入新记录
+        removeNode(nameId);
+    }
+    
+    insertNode(allocNode(nameId, score, timestamp));
+    return true;
 }
 
 bool RankList::remove(const std::string& username) {
-    if (head_ == nullptr) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint32_t nameId = names_.find(username);
+    if (nameId == StringPool::npos || !removeNode(nameId)) {
         return false;
     }
     
-    // 如果是头节点
-    if (head_->username == username) {
-        RankNode* temp = head_;
-        head_ = head_->next;
-        delete temp;
-        return true;
+    pendingLog_.push_back({nameId, -1, 0});  // 日志中的删除标记
+    publishIfDirty();
+    return true;
+}
+
+bool RankList::removeNode(uint32_t nameId) {
+    int32_t target = findNode(nameId);
+    if (target == -1) {
+        return false;
     }
     
-    // 查找要删除的节点
-    RankNode* current = head_;
-    while (current->next != nullptr) {
-        if (current->next->username == username) {
-            RankNode* temp = current->next;
-            current->next = temp->next;
-            delete temp;
-            return true;
+    // 找到前驱并摘除，同时数出名次
+    size_t rank = 0;
+    if (head_ == target) {
+        head_ = nodes_[target].next;
+    } else {
+        int32_t current = head_;
+        rank = 1;
+        while (nodes_[current].next != target) {
+            current = nodes_[current].next;
+            ++rank;
         }
-        current = current->next;
+        nodes_[current].next = nodes_[target].next;
     }
     
-    return false;
+    if (!rebuildChunks_) {
+        chunkErase(rank);
+    }
+    
+    bestScores_.add(nodes_[target].score, -1);
+    
+    // 归还节点池
+    nodes_[target].next = freeHead_;
+    freeHead_ = target;
+    nodeOfName_[nameId] = -1;
+    
+    --count_;
+    dirty_ = true;
+    return true;
+}
+
+std::shared_ptr<const RankSnapshot> RankList::snapshot() const {
+    return std::atomic_load(&snapshot_);
 }
 
 int RankList::getBestScore() const {
-    if (head_ == nullptr) {
-        return 0;
-    }
-    return head_->score; // 链表已按分数降序排列
+    return snapshot()->getBestScore();
 }
 
 int RankList::getUserScore(const std::string& username) const {
-    RankNode* current = head_;
-    while (current != nullptr) {
-        if (current->username == username) {
-            return current->score;
-        }
-        current = current->next;
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint32_t nameId = names_.find(username);
+    if (nameId == StringPool::npos) {
+        return 0;
     }
-    return 0;
+    
+    int32_t node = findNode(nameId);
+    return node == -1 ? 0 : nodes_[node].score;
 }
 
 std::vector<std::pair<std::string, int>> RankList::getAll() const {
-    std::vector<std::pair<std::string, int>> result;
+    auto snap = snapshot();
+    std::vector<RankEntryView> views;
+    snap->getPage(0, snap->size(), views);
     
-    RankNode* current = head_;
-    while (current != nullptr) {
-        result.push_back({current->username, current->score});
-        current = current->next;
+    std::vector<std::pair<std::string, int>> result;
+    result.reserve(views.size());
+    for (const auto& view : views) {
+        result.push_back({std::string(view.username), view.score});
     }
     
     return result;
 }
 
+size_t RankList::size() const {
+    return snapshot()->size();
+}
+
+double RankList::percentileOf(int score) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return bestScores_.rankOf(score);
+}
+
+std::vector<PeriodRollup> RankList::periodRollups() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return periods_.rollups();
+}
+
+ScoreSketch RankList::bestScoreSketch() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return bestScores_;
+}
+
+ScoreSketch RankList::gameScoreSketch(ScorePeriod period) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    long today = PeriodRanks::dayOf(static_cast<int64_t>(std::time(nullptr)));
+    long firstDay = period == ScorePeriod::TODAY ? today : today - 6;
+    
+    ScoreSketch result;
+    for (const auto& day : recentDays_) {
+        if (day.day >= firstDay && day.day <= today) {
+            result.merge(day.sketch);
+        }
+    }
+    return result;
+}
+
+void RankList::recordGame(int score) {
+    long today = PeriodRanks::dayOf(static_cast<int64_t>(std::time(nullptr)));
+    DaySketch& slot = recentDays_[static_cast<size_t>(today % static_cast<long>(recentDays_.size()))];
+    
+    // 环形复用：槽位属于更早的日子时清空
+    if (slot.day != today) {
+        slot.day = today;
+        slot.sketch.clear();
+    }
+    slot.sketch.add(score);
+}
+
+size_t RankSnapshot::getPage(size_t offset, size_t count, std::vector<RankEntryView>& out) const {
+    out.clear();
+    
+    if (offset >= size_) {
+        return 0;
+    }
+    
+    // 二分找到offset所在分块，然后顺序读取
+    size_t chunk = static_cast<size_t>(std::upper_bound(chunkStart_.begin(), chunkStart_.end(), offset)
+                                       - chunkStart_.begin()) - 1;
+    size_t index = offset - chunkStart_[chunk];
+    size_t rank = offset;
+    
+    while (out.size() < count && chunk < chunks_.size()) {
+        const RankChunk& current = *chunks_[chunk];
+        for (; index < current.entries.size() && out.size() < count; ++index) {
+            out.push_back({current.nameAt(index), current.entries[index].score, static_cast<int>(++rank)});
+        }
+        ++chunk;
+        index = 0;
+    }
+    
+    return out.size();
+}
+
+size_t RankSnapshot::getPeriodTop(RankPeriod period, std::vector<RankEntryView>& out) const {
+    if (period == RankPeriod::ALL_TIME) {
+        return getPage(0, PERIOD_TOP_SIZE, out);
+    }
+    
+    out.clear();
+    const auto& top = period == RankPeriod::DAILY ? dailyTop_ : weeklyTop_;
+    if (top) {
+        for (size_t i = 0; i < top->entries.size(); ++i) {
+            out.push_back({top->nameAt(i), top->entries[i].score, static_cast<int>(i + 1)});
+        }
+    }
+    return out.size();
+}
+
 void RankList::clear() {
-    while (head_ != nullptr) {
-        RankNode* temp = head_;
-        head_ = head_->next;
-        delete temp;
+    std::lock_guard<std::mutex> guard(mutex_);
+    clearUnlocked();
+    periods_ = PeriodRanks();
+    periodsDirty_ = true;
+    periodTopStale_ = true;
+    publishIfDirty();
+}
+
+void RankList::clearUnlocked() {
+    // 节点池和字符串池整体释放，无需逐个delete
+    nodes_.clear();
+    nodeOfName_.clear();
+    names_.clear();
+    head_ = -1;
+    freeHead_ = -1;
+    count_ = 0;
+    bestScores_.clear();
+    dirty_ = true;
+    rebuildChunks_ = true;
+    
+    // 清空后日志无法表达，下次保存时整体重写
+    pendingLog_.clear();
+    rewritePending_ = true;
+    
+    // 时段榜单不在这里清空：重新加载时按最大值合并文件内容，本地未落盘的记录要保留
+}
+
+namespace {
+
+// 分块目标大小：超过两倍时拆分
+const size_t kChunkSize = 256;
+
+void appendEntry(RankChunk& chunk, std::string_view name, int score) {
+    chunk.entries.push_back({static_cast<uint32_t>(chunk.names.size()),
+                             static_cast<uint32_t>(name.size()), score});
+    chunk.names.insert(chunk.names.end(), name.begin(), name.end());
+}
+
+// 找到名次rank所在的分块及块内下标；rank等于总数时返回最后一块的末尾
+size_t locateChunk(const std::vector<std::shared_ptr<const RankChunk>>& chunks, size_t& rank) {
+    size_t chunk = 0;
+    while (chunk + 1 < chunks.size() && rank >= chunks[chunk]->entries.size()) {
+        rank -= chunks[chunk]->entries.size();
+        ++chunk;
     }
+    return chunk;
 }
 
-void RankList::insertNode(RankNode* node) {
-    // 按分数降序插入
-    if (head_ == nullptr || node->score > head_->score) {
-        // 插入到头部
-        node->next = head_;
-        head_ = node;
+} // namespace
+
+void RankList::chunkInsert(size_t rank, uint32_t nameId, int score) {
+    if (chunks_.empty()) {
+        chunks_.push_back(std::make_shared<const RankChunk>());
+    }
+    
+    size_t index = rank;
+    size_t chunk = locateChunk(chunks_, index);
+    const RankChunk& old = *chunks_[chunk];
+    
+    // 复制该分块并在index处插入（顺带压缩掉已删除条目留下的用户名）
+    auto copy = std::make_shared<RankChunk>();
+    copy->entries.reserve(old.entries.size() + 1);
+    copy->names.reserve(old.names.size() + 16);
+    for (size_t i = 0; i <= old.entries.size(); ++i) {
+        if (i == index) {
+            appendEntry(*copy, names_.get(nameId), score);
+        }
+        if (i < old.entries.size()) {
+            appendEntry(*copy, old.nameAt(i), old.entries[i].score);
+        }
+    }
+    
+    if (copy->entries.size() <= kChunkSize * 2) {
+        chunks_[chunk] = std::move(copy);
         return;
     }
     
-    // 查找插入位置
-    RankNode* current = head_;
-    while (current->next != nullptr && current->next->score >= node->score) {
-        current = current->next;
+    // 过大则对半拆分
+    auto right = std::make_shared<RankChunk>();
+    auto left = std::make_shared<RankChunk>();
+    size_t half = copy->entries.size() / 2;
+    for (size_t i = 0; i < copy->entries.size(); ++i) {
+        appendEntry(i < half ? *left : *right, copy->nameAt(i), copy->entries[i].score);
     }
+    chunks_[chunk] = std::move(left);
+    chunks_.insert(chunks_.begin() + chunk + 1, std::move(right));
+}
+
+void RankList::chunkErase(size_t rank) {
+    size_t index = rank;
+    size_t chunk = locateChunk(chunks_, index);
+    const RankChunk& old = *chunks_[chunk];
     
-    // 插入
-    node->next = current->next;
-    current->next = node;
+    if (old.entries.size() == 1) {
+        chunks_.erase(chunks_.begin() + chunk);
+        return;
+    }
+    
+    auto copy = std::make_shared<RankChunk>();
+    copy->entries.reserve(old.entries.size() - 1);
+    copy->names.reserve(old.names.size());
+    for (size_t i = 0; i < old.entries.size(); ++i) {
+        if (i != index) {
+            appendEntry(*copy, old.nameAt(i), old.entries[i].score);
+        }
+    }
+    chunks_[chunk] = std::move(copy);
 }
 
-RankNode* RankList::findNode(const std::string& username) {
-    RankNode* current = head_;
-    while (current != nullptr) {
-        if (current->username == username) {
-            return current;
+void RankList::publishIfDirty() {
+    if (!dirty_) {
+        return;
+    }
+    
+    // 批量修改（加载/清空/重新同步）后从链表整体重建分块
+    if (rebuildChunks_) {
+        chunks_.clear();
+        std::shared_ptr<RankChunk> chunk;
+        for (int32_t current = head_; current != -1; current = nodes_[current].next) {
+            if (!chunk || chunk->entries.size() == kChunkSize) {
+                if (chunk) {
+                    chunks_.push_back(std::move(chunk));
+                }
+                chunk = std::make_shared<RankChunk>();
+                chunk->entries.reserve(kChunkSize);
+            }
+            appendEntry(*chunk, names_.get(nodes_[current].nameId), nodes_[current].score);
+        }
+        if (chunk) {
+            chunks_.push_back(std::move(chunk));
+        }
+        rebuildChunks_ = false;
+    }
+    
+    // 日榜/周榜前N名：有序集合取前N项，O(log n + N)
+    if (periodTopStale_) {
+        for (RankPeriod period : {RankPeriod::DAILY, RankPeriod::WEEKLY}) {
+            auto top = std::make_shared<RankChunk>();
+            for (const auto& entry : periods_.top(period, RankSnapshot::PERIOD_TOP_SIZE)) {
+                appendEntry(*top, entry.first, entry.second);
+            }
+            (period == RankPeriod::DAILY ? dailyTop_ : weeklyTop_) = std::move(top);
+        }
+        periodTopStale_ = false;
+    }
+    
+    // 新快照只复制分块指针和起始名次，O(n / kChunkSize)
+    auto snap = std::make_shared<RankSnapshot>();
+    snap->version_ = ++version_;
+    snap->chunks_ = chunks_;
+    snap->dailyTop_ = dailyTop_;
+    snap->weeklyTop_ = weeklyTop_;
+    snap->chunkStart_.reserve(chunks_.size());
+    for (const auto& chunk : chunks_) {
+        snap->chunkStart_.push_back(snap->size_);
+        snap->size_ += chunk->entries.size();
+    }
+    
+    std::atomic_store(&snapshot_, std::shared_ptr<const RankSnapshot>(std::move(snap)));
+    dirty_ = false;
+}
+
+int32_t RankList::allocNode(uint32_t nameId, int score, int64_t timestamp) {
+    int32_t node;
+    if (freeHead_ != -1) {
+        node = freeHead_;
+        freeHead_ = nodes_[node].next;
+        nodes_[node] = {nameId, score, -1, timestamp};
+    } else {
+        node = static_cast<int32_t>(nodes_.size());
+        nodes_.push_back({nameId, score, -1, timestamp});
+    }
+    
+    nodeOfName_[nameId] = node;
+    return node;
+}
+
+void RankList::insertNode(int32_t node) {
+    ++count_;
+    dirty_ = true;
+    bestScores_.add(nodes_[node].score);
+    
+    // 按分数降序插入
+    size_t rank = 0;
+    if (head_ == -1 || nodes_[node].score > nodes_[head_].score) {
+        // 插入到头部
+        nodes_[node].next = head_;
+        head_ = node;
+    } else {
+        // 查找插入位置，同时数出名次
+        int32_t current = head_;
+        rank = 1;
+        while (nodes_[current].next != -1 && nodes_[nodes_[current].next].score >= nodes_[node].score) {
+            current = nodes_[current].next;
+            ++rank;
         }
-        current = current->next;
+        
+        // 插入
+        nodes_[node].next = nodes_[current].next;
+        nodes_[current].next = node;
+    }
+    
+    if (!rebuildChunks_) {
+        chunkInsert(rank, nodes_[node].nameId, nodes_[node].score);
     }
-    return nullptr;
 }
 
+int32_t RankList::findNode(uint32_t nameId) const {
+    // 用户名id直接映射到节点，O(1)
+    if (nameId >= nodeOfName_.size()) {
+        return -1;
+    }
+    return nodeOfName_[nameId];
+}
@@ -1,10 +1,13 @@
 #include "Renderer.h"
 #include "Board.h"
+#include "FrameSnapshot.h"
+#include "HintSearch.h"
 #include "Menu.h"
 #include "RankList.h"
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 
 Renderer::Renderer(sf::RenderWindow& window) 
@@ -67,11 +70,30 @@ bool Renderer::init() {
 }
 
 
+void Renderer::renderFrame(const FrameSnapshot& frame) {
+    switch (frame.screen) {
+        case FrameScreen::MENU:
+            renderMenu(frame.menu);
+            break;
+        case FrameScreen::RANK_LIST:
+            if (frame.ranks) {
+                renderRankList(*frame.ranks, frame.menu);
+            }
+            break;
+        case FrameScreen::BOARD:
+            render(frame.board, frame.tiles, frame.username, frame.bestScore, frame.statusText,
+                   frame.detailText, frame.hasHint ? &frame.hint : nullptr);
+            break;
+    }
+}
+
 void Renderer::render(const Board& board, 
                       const std::vector<VisualTile>& visualTiles,
                       const std::string& username,
                       int bestScore,
-                      const std::string& statusText) {
+                      const std::string& statusText,
+                      const std::string& detailText,
+                      const Hint* hint) {
 window_.clear(sf::Color(250, 248, 239));  // 背景色
 
 drawBackground();
@@ -130,7 +152,11 @@ if (visualTiles.empty()) {
     }
 }
 
-drawUI(username, board.getScore(), bestScore, statusText);
+if (hint) {
+    drawHint(*hint);
+}
+
+drawUI(username, board.getScore(), bestScore, statusText, detailText);
 window_.display();
 }
 
@@ -209,8 +235,45 @@ void Renderer::drawTileAt(float x, float y, int value, float scale) {
     window_.draw(text);
 }
 
+void Renderer::drawHint(const Hint& hint) {
+    // 箭头画在网格中央，先按向上的形状定义，再按方向旋转；置信度越高越不透明
+    float gridSize = cellSize_ * 4 + padding_ * 3;
+    float centerX = gridStartX_ + gridSize / 2.0f;
+    float centerY = gridStartY_ + gridSize / 2.0f;
+    
+    sf::ConvexShape arrow(7);
+    arrow.setPoint(0, sf::Vector2f(0.0f, -70.0f));
+    arrow.setPoint(1, sf::Vector2f(50.0f, -15.0f));
+    arrow.setPoint(2, sf::Vector2f(18.0f, -15.0f));
+    arrow.setPoint(3, sf::Vector2f(18.0f, 60.0f));
+    arrow.setPoint(4, sf::Vector2f(-18.0f, 60.0f));
+    arrow.setPoint(5, sf::Vector2f(-18.0f, -15.0f));
+    arrow.setPoint(6, sf::Vector2f(-50.0f, -15.0f));
+    arrow.setPosition(centerX, centerY);
+    
+    float angle = 0.0f;
+    switch (hint.dir) {
+        case Direction::UP:    angle = 0.0f;   break;
+        case Direction::RIGHT: angle = 90.0f;  break;
+        case Direction::DOWN:  angle = 180.0f; break;
+        case Direction::LEFT:  angle = 270.0f; break;
+    }
+    arrow.setRotation(angle);
+    
+    sf::Uint8 alpha = static_cast<sf::Uint8>(90 + std::min(100, std::max(0, hint.confidence)) * 3 / 2);
+    arrow.setFillColor(sf::Color(246, 124, 95, alpha));
+    arrow.setOutlineColor(sf::Color(249, 246, 242, alpha));
+    arrow.setOutlineThickness(3.0f);
+    window_.draw(arrow);
+    
+    // 置信度和搜索深度写在网格下方（补充说明的上面）
+    std::ostringstream label;
+    label << "Hint " << hint.confidence << "%  depth " << hint.depth << "  (T to hide)";
+    drawText(label.str(), centerX, gridStartY_ + cellSize_ * 4 + padding_ * 5 + 60.0f, 20, sf::Color(119, 110, 101));
+}
+
 void Renderer::drawUI(const std::string& username, int score, int bestScore, 
-                     const std::string& statusText) {
+                     const std::string& statusText, const std::string& detailText) {
     // 绘制用户名
     sf::Text userText;
     userText.setFont(font_);
@@ -282,6 +345,12 @@ void Renderer::drawUI(const std::string& username, int score, int bestScore,
         );
         window_.draw(status);
     }
+    
+    // 绘制状态下方的补充说明（如游戏结束时的分数分布）
+    if (!detailText.empty()) {
+        drawText(detailText, window_.getSize().x / 2.0f,
+                 gridStartY_ + cellSize_ * 4 + padding_ * 5 + 100.0f, 20, sf::Color(119, 110, 101));
+    }
 }
 
 sf::Color Renderer::getTileColor(int value) const {
@@ -361,41 +430,41 @@ sf::Color Renderer::darkenColor(const sf::Color& color, float factor) const {
     );
 }
 
-void Renderer::renderMenu(const Menu& menu) {
+void Renderer::renderMenu(const MenuView& menu) {
     window_.clear(sf::Color(250, 248, 239));
     
     // 绘制标题
     drawText("2048", window_.getSize().x / 2.0f, 100, 80, sf::Color(119, 110, 101));
     
     // 获取输入框位置
-    float inputX, inputY, inputWidth, inputHeight;
-    menu.getInputBox(inputX, inputY, inputWidth, inputHeight);
+    float inputX = menu.inputBoxX, inputY = menu.inputBoxY;
+    float inputWidth = menu.inputBoxWidth, inputHeight = menu.inputBoxHeight;
     
     // 如果输入框激活，绘制高亮边框
-    if (menu.isInputActive()) {
+    if (menu.inputActive) {
         drawRoundedRect(inputX - 3, inputY - 3, inputWidth + 6, inputHeight + 6, 
                        5, sf::Color(237, 194, 46));
     }
     
     // 绘制输入框背景（悬停时变暗）
     sf::Color inputBgColor = sf::Color(187, 173, 160);
-    if (menu.isInputBoxHovered() && !menu.isInputActive()) {
+    if (menu.inputBoxHovered && !menu.inputActive) {
         inputBgColor = darkenColor(inputBgColor, 0.85f);
     }
     drawRoundedRect(inputX, inputY, inputWidth, inputHeight, 5, inputBgColor);
     
     // 绘制提示文字
-    std::string prompt = menu.isInputActive() ? "请输入您的名字:" : "点击输入框以输入名字";
+    std::string prompt = menu.inputActive ? "请输入您的名字:" : "点击输入框以输入名字";
     drawText(prompt, window_.getSize().x / 2.0f, 220, 24, sf::Color(119, 110, 101));
     
     // 绘制玩家名称
-    std::string displayName = menu.getPlayerName();
-    if (menu.isInputActive() && displayName == "玩家") {
+    std::string displayName = menu.playerName;
+    if (menu.inputActive && displayName == "玩家") {
         displayName = "";
     }
     
     // 添加光标（如果激活）
-    if (menu.isInputActive()) {
+    if (menu.inputActive) {
         static sf::Clock cursorClock;
         if (cursorClock.getElapsedTime().asMilliseconds() / 500 % 2 == 0) {
             displayName += "|";
@@ -405,16 +474,20 @@ void Renderer::renderMenu(const Menu& menu) {
     drawText(displayName, window_.getSize().x / 2.0f, inputY + inputHeight / 2, 
             28, sf::Color(255, 255, 255));
     
-    // 绘制按钮
-    if (menu.hasLoadGame()) {
-        drawButton(menu.getContinueButton(), menu.isButtonHovered(menu.getContinueButton()));
-        drawButton(menu.getNewGameButton(), menu.isButtonHovered(menu.getNewGameButton()));
-    } else {
-        drawButton(menu.getStartButton(), menu.isButtonHovered(menu.getStartButton()));
+    // 绘制按钮（有存档时为继续/新游戏，否则为开始；然后是排行榜和退出）
+    for (const auto& button : menu.buttons) {
+        drawButton(button.button, button.hovered);
     }
     
-    drawButton(menu.getRankButton(), menu.isButtonHovered(menu.getRankButton()));
-    drawButton(menu.getQuitButton(), menu.isButtonHovered(menu.getQuitButton()));
+    // 绘制名字补全建议（下拉列表覆盖在按钮之上）
+    for (const auto& row : menu.suggestions) {
+        drawRoundedRect(row.x, row.y, row.width, row.height, 5,
+                        row.selected ? sf::Color(237, 194, 46) : sf::Color(238, 228, 218));
+        
+        sf::Color textColor = row.selected ? sf::Color(255, 255, 255) : sf::Color(119, 110, 101);
+        drawText(row.username, row.x + 15, row.y + 4, 20, textColor, false);
+        drawText(std::to_string(row.score), row.x + row.width - 80, row.y + 4, 20, textColor, false);
+    }
     
     // 绘制操作提示
     drawText("提示: 鼠标点击按钮进行操作", window_.getSize().x / 2.0f, 
@@ -423,39 +496,66 @@ void Renderer::renderMenu(const Menu& menu) {
     window_.display();
 }
 
-void Renderer::renderRankList(const RankList& rankList, const Menu& menu) {
+void Renderer::renderRankList(const RankSnapshot& snapshot, const MenuView& menu) {
     window_.clear(sf::Color(250, 248, 239));
     
-    // 绘制标题
-    drawText("排行榜", window_.getSize().x / 2.0f, 80, 50, sf::Color(119, 110, 101));
+    // 绘制标题和时段切换提示
+    RankPeriod period = menu.rankPeriod;
+    const char* periodName = period == RankPeriod::DAILY ? "今日" :
+                             period == RankPeriod::WEEKLY ? "本周" : "总榜";
+    drawText("排行榜", window_.getSize().x / 2.0f, 70, 50, sf::Color(119, 110, 101));
+    drawText(std::string("<  ") + periodName + "  >", window_.getSize().x / 2.0f, 125, 20,
+             sf::Color(143, 122, 102));
     
     // 绘制排行榜背景（居中：(600-500)/2 = 50）
     drawRoundedRect(50, 150, 500, 480, 10, sf::Color(187, 173, 160));
     
-    // 绘制排行榜内容
-    auto ranks = rankList.getAll();
+    // 绘制排行榜内容（从快照只取当前可见的一页，不复制整个榜单）
+    // 日榜/周榜只发布前N名，不滚动
+    size_t total;
+    size_t offset = 0;
+    if (period == RankPeriod::ALL_TIME) {
+        total = snapshot.size();
+        offset = std::min(menu.rankScrollOffset,
+                          total > Menu::RANK_VISIBLE_ROWS ? total - Menu::RANK_VISIBLE_ROWS : 0);
+        snapshot.getPage(offset, Menu::RANK_VISIBLE_ROWS, rankPage_);
+    } else {
+        total = snapshot.getPeriodTop(period, rankPage_);
+    }
     
-    if (ranks.empty()) {
+    if (total == 0) {
         drawText("暂无记录", window_.getSize().x / 2.0f, 400, 24, sf::Color(255, 255, 255));
     } else {
         int y = 200;
-        int rank = 1;
         
-        for (const auto& entry : ranks) {
-            if (rank > 10) break;  // 最多显示10名
-            
+        for (const auto& entry : rankPage_) {
             std::stringstream ss;
-            ss << rank << ". " << entry.first << " - " << entry.second;
+            ss << entry.rank << ". " << entry.username << " - " << entry.score;
             
             drawText(ss.str(), 80, y, 20, sf::Color(255, 255, 255), false);
             
             y += 40;
-            rank++;
+        }
+        
+        // 榜单超过一屏时绘制滚动条和范围提示
+        if (total > Menu::RANK_VISIBLE_ROWS) {
+            float trackY = 190.0f;
+            float trackHeight = 400.0f;
+            float thumbHeight = std::max(20.0f, trackHeight * Menu::RANK_VISIBLE_ROWS / total);
+            float maxOffset = static_cast<float>(total - Menu::RANK_VISIBLE_ROWS);
+            float thumbY = trackY + (trackHeight - thumbHeight) * (offset / maxOffset);
+            
+            drawRoundedRect(525, trackY, 8, trackHeight, 4, sf::Color(205, 193, 180));
+            drawRoundedRect(525, thumbY, 8, thumbHeight, 4, sf::Color(143, 122, 102));
+            
+            std::stringstream range;
+            range << offset + 1 << "-" << offset + rankPage_.size() << " / " << total;
+            drawText(range.str(), window_.getSize().x / 2.0f, 610, 16, sf::Color(255, 255, 255));
         }
     }
     
     // 绘制返回按钮
-    drawButton(menu.getBackButton(), menu.isButtonHovered(menu.getBackButton()));
+    drawButton(menu.backButton.button, menu.backButton.hovered);
     
     window_.display();
 }
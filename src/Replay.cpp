@@ -0,0 +1,203 @@
+#include "Replay.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+const char kMagic[8] = {'2', '0', '4', '8', 'R', 'P', 'L', '1'};
+const size_t kHeaderSize = 8 + 8 + 8 + 4 + 4 + 4 + 16 + 2;
+
+template <typename T>
+void put(char*& p, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        p[i] = static_cast<char>((static_cast<uint64_t>(value) >> (i * 8)) & 0xff);
+    }
+    p += sizeof(T);
+}
+
+template <typename T>
+T get(const char*& p) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (i * 8);
+    }
+    p += sizeof(T);
+    return static_cast<T>(value);
+}
+
+uint8_t tileLog2(int value) {
+    uint8_t log = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++log;
+    }
+    return log;
+}
+
+// 紧凑表示中是否有32768（半字节为15）
+bool hasMaxTile(uint64_t packed) {
+    return (packed & (packed >> 1) & (packed >> 2) & (packed >> 3) & 0x1111111111111111ULL) != 0;
+}
+
+} // namespace
+
+Replay::Replay()
+    : rngState_(0), timestamp_(0), startScore_(0), finalScore_(0), moveCount_(0) {
+    std::memset(startGrid_, 0, sizeof(startGrid_));
+}
+
+void Replay::begin(const std::string& username, const Board& board) {
+    username_ = username;
+    rngState_ = board.getRngState();
+    timestamp_ = 0;
+    startScore_ = board.getScore();
+    finalScore_ = board.getScore();
+    moveCount_ = 0;
+    moves_.clear();
+    
+    for (int i = 0; i < 16; ++i) {
+        startGrid_[i] = tileLog2(board.getValue(i / 4, i % 4));
+    }
+}
+
+void Replay::append(Direction dir) {
+    if ((moveCount_ & 3) == 0) {
+        moves_.push_back(0);
+    }
+    moves_.back() |= static_cast<uint8_t>(static_cast<uint8_t>(dir) << ((moveCount_ & 3) * 2));
+    ++moveCount_;
+}
+
+void Replay::truncate(size_t moveCount) {
+    if (moveCount >= moveCount_) {
+        return;
+    }
+    
+    moveCount_ = moveCount;
+    moves_.resize((moveCount_ + 3) / 4);
+    if ((moveCount_ & 3) != 0) {
+        // 清掉最后一个字节中被丢弃的步
+        moves_.back() &= static_cast<uint8_t>((1u << ((moveCount_ & 3) * 2)) - 1);
+    }
+}
+
+void Replay::finish(int finalScore, int64_t timestamp) {
+    finalScore_ = finalScore;
+    timestamp_ = timestamp;
+}
+
+void Replay::startBoard(Board& board) const {
+    int grid[4][4];
+    for (int i = 0; i < 16; ++i) {
+        grid[i / 4][i % 4] = startGrid_[i] == 0 ? 0 : 1 << startGrid_[i];
+    }
+    board.setGrid(grid);
+    board.setScore(startScore_);
+    board.setRngState(rngState_);
+}
+
+bool Replay::play(Board& board) const {
+    startBoard(board);
+    size_t i = 0;
+    
+    // 在紧凑表示上查行表移动、生成新方块（与 Board 的随机数规则一致），最后才写回网格
+    // 行表不合并两个32768，出现32768后剩下的步改走网格路径
+    uint64_t packed;
+    if (board.pack(packed)) {
+        uint64_t rngState = rngState_;
+        int score = startScore_;
+        for (; i < moveCount_ && !hasMaxTile(packed); ++i) {
+            int gain = 0;
+            uint64_t moved = Board::movePacked(packed, moveAt(i), &gain);
+            if (moved == packed) {
+                return false;
+            }
+            score += gain;
+            packed = Board::spawnPacked(moved, rngState);
+        }
+        board.unpack(packed);
+        board.setScore(score);
+        board.setRngState(rngState);
+    }
+    
+    for (; i < moveCount_; ++i) {
+        if (!board.applyMove(moveAt(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<char> Replay::encode() const {
+    std::vector<char> out(kHeaderSize + username_.size() + moves_.size());
+    char* p = out.data();
+    
+    std::memcpy(p, kMagic, sizeof(kMagic));
+    p += sizeof(kMagic);
+    put<uint64_t>(p, rngState_);
+    put<int64_t>(p, timestamp_);
+    put<uint32_t>(p, static_cast<uint32_t>(startScore_));
+    put<uint32_t>(p, static_cast<uint32_t>(finalScore_));
+    put<uint32_t>(p, static_cast<uint32_t>(moveCount_));
+    std::memcpy(p, startGrid_, 16);
+    p += 16;
+    put<uint16_t>(p, static_cast<uint16_t>(username_.size()));
+    std::memcpy(p, username_.data(), username_.size());
+    p += username_.size();
+    if (!moves_.empty()) {
+        std::memcpy(p, moves_.data(), moves_.size());
+    }
+    return out;
+}
+
+bool Replay::decode(const char* data, size_t size) {
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    
+    const char* p = data + sizeof(kMagic);
+    rngState_ = get<uint64_t>(p);
+    timestamp_ = get<int64_t>(p);
+    startScore_ = static_cast<int>(get<uint32_t>(p));
+    finalScore_ = static_cast<int>(get<uint32_t>(p));
+    moveCount_ = get<uint32_t>(p);
+    std::memcpy(startGrid_, p, 16);
+    p += 16;
+    size_t nameLength = get<uint16_t>(p);
+    
+    size_t moveBytes = (moveCount_ + 3) / 4;
+    if (size != kHeaderSize + nameLength + moveBytes) {
+        return false;
+    }
+    
+    username_.assign(p, nameLength);
+    p += nameLength;
+    moves_.assign(reinterpret_cast<const uint8_t*>(p), reinterpret_cast<const uint8_t*>(p) + moveBytes);
+    return true;
+}
+
+bool Replay::writeTo(const std::string& path) const {
+    // 先写临时文件再原子替换，读者不会看到半截回放
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::vector<char> bytes = encode();
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    
+    if (file.fail() || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Replay::readFrom(const std::string& path) {
+    MappedFile file;
+    return file.open(path) && decode(file.data(), file.size());
+}
@@ -0,0 +1,63 @@
+#include "ReplayPlayer.h"
+#include <algorithm>
+
+ReplayPlayer::ReplayPlayer() : position_(0) {
+}
+
+bool ReplayPlayer::load(const std::string& path) {
+    Replay replay;
+    return replay.readFrom(path) && load(replay);
+}
+
+bool ReplayPlayer::load(const Replay& replay) {
+    replay_ = replay;
+    keyframes_.clear();
+    keyframes_.reserve(replay_.moveCount() / KEYFRAME_INTERVAL + 1);
+    
+    // 完整回放一遍，沿途记录关键帧
+    Board board;
+    replay_.startBoard(board);
+    keyframes_.push_back(board);
+    for (size_t i = 0; i < replay_.moveCount(); ++i) {
+        if (!board.applyMove(replay_.moveAt(i))) {
+            keyframes_.clear();
+            return false;  // 回放与局面不符（文件损坏）
+        }
+        if ((i + 1) % KEYFRAME_INTERVAL == 0) {
+            keyframes_.push_back(board);
+        }
+    }
+    
+    board_ = keyframes_.front();
+    position_ = 0;
+    return true;
+}
+
+bool ReplayPlayer::step() {
+    if (atEnd()) {
+        return false;
+    }
+    
+    board_.applyMove(replay_.moveAt(position_));
+    ++position_;
+    return true;
+}
+
+void ReplayPlayer::seek(size_t move) {
+    if (keyframes_.empty()) {
+        return;
+    }
+    
+    move = std::min(move, replay_.moveCount());
+    
+    // 目标在当前位置之后且不超过一个关键帧间隔时直接前进，否则从关键帧出发
+    if (move < position_ || move - position_ > KEYFRAME_INTERVAL) {
+        size_t keyframe = move / KEYFRAME_INTERVAL;
+        board_ = keyframes_[keyframe];
+        position_ = keyframe * KEYFRAME_INTERVAL;
+    }
+    
+    while (position_ < move) {
+        step();
+    }
+}
@@ -1,5 +1,6 @@
 #include "SaveManager.h"
 #include "Board.h"
+#include "Replay.h"
 #include <fstream>
 #include <sys/stat.h>
 
@@ -33,6 +34,9 @@ bool SaveManager::save(const std::string& username, const Board& board) {
         file << "\n";
     }
     
+    // 写入随机数状态（继续游戏后生成的方块与回放一致）
+    file << board.getRngState() << "\n";
+    
     file.close();
     return true;
 }
@@ -67,11 +71,18 @@ bool SaveManager::load(std::string& username, Board& board) {
         }
     }
     
+    // 随机数状态（旧存档没有这一行，保留Board当前状态）
+    uint64_t rngState;
+    bool hasRngState = static_cast<bool>(file >> rngState);
+    
     file.close();
     
     // 应用到Board
     board.setGrid(grid);
     board.setScore(score);
+    if (hasRngState) {
+        board.setRngState(rngState);
+    }
     
     return true;
 }
@@ -83,5 +94,22 @@ bool SaveManager::hasSave() const {
 
 void SaveManager::deleteSave() {
     std::remove(saveFilePath_.c_str());
+    deleteReplay();
+}
+
+void SaveManager::deleteReplay() {
+    std::remove(replayFilePath().c_str());
+}
+
+bool SaveManager::saveReplay(const Replay& replay) {
+    return replay.writeTo(replayFilePath());
+}
+
+bool SaveManager::loadReplay(Replay& replay) {
+    return replay.readFrom(replayFilePath());
+}
+
+std::string SaveManager::replayFilePath() const {
+    return saveFilePath_ + ".replay";
 }
 
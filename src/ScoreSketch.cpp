@@ -0,0 +1,100 @@
+#include "ScoreSketch.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// 相邻桶比例 gamma = (1 + a) / (1 - a)，a = 1%
+const double kGamma = 1.0 + 2.0 * 0.01 / (1.0 - 0.01);
+const double kLogGamma = std::log(kGamma);
+
+} // namespace
+
+ScoreSketch::ScoreSketch() : counts_(kBuckets, 0), tree_(kBuckets + 1, 0), total_(0) {
+}
+
+void ScoreSketch::add(int score, int count) {
+    int bucket = bucketOf(score);
+    counts_[bucket] += count;
+    total_ += count;
+    
+    for (int i = bucket + 1; i <= kBuckets; i += i & -i) {
+        tree_[i] += count;
+    }
+}
+
+void ScoreSketch::merge(const ScoreSketch& other) {
+    for (int b = 0; b < kBuckets; ++b) {
+        counts_[b] += other.counts_[b];
+        tree_[b + 1] += other.tree_[b + 1];  // 树状数组按位相加仍然有效
+    }
+    total_ += other.total_;
+}
+
+void ScoreSketch::clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    std::fill(tree_.begin(), tree_.end(), 0);
+    total_ = 0;
+}
+
+double ScoreSketch::rankOf(int score) const {
+    if (total_ == 0) {
+        return 0.0;
+    }
+    
+    return static_cast<double>(countBelow(bucketOf(score))) / static_cast<double>(total_);
+}
+
+int ScoreSketch::quantile(double q) const {
+    if (total_ == 0) {
+        return 0;
+    }
+    
+    // 在树状数组上二分：找到第一个前缀和超过 rank 的桶
+    int64_t rank = static_cast<int64_t>(std::clamp(q, 0.0, 1.0) * (total_ - 1));
+    int pos = 0;
+    for (int step = kBuckets; step > 0; step /= 2) {
+        if (pos + step <= kBuckets && tree_[pos + step] <= rank) {
+            pos += step;
+            rank -= tree_[pos];
+        }
+    }
+    return bucketValue(std::min(pos, kBuckets - 1));
+}
+
+void ScoreSketch::histogram(const std::vector<int>& edges, std::vector<uint64_t>& out) const {
+    out.assign(edges.size() + 1, 0);
+    
+    // 每个区间用两次前缀和相减得到；分界落在桶内时按桶整体归属
+    int64_t previous = 0;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        int64_t below = countBelow(bucketOf(edges[i]));
+        out[i] = static_cast<uint64_t>(below - previous);
+        previous = below;
+    }
+    out.back() = total_ - static_cast<uint64_t>(previous);
+}
+
+int ScoreSketch::bucketOf(int score) {
+    if (score <= 0) {
+        return 0;
+    }
+    int bucket = 1 + static_cast<int>(std::ceil(std::log(static_cast<double>(score)) / kLogGamma));
+    return std::min(bucket, kBuckets - 1);
+}
+
+int ScoreSketch::bucketValue(int bucket) {
+    if (bucket == 0) {
+        return 0;
+    }
+    // 桶 (gamma^(b-2), gamma^(b-1)] 的中点，相对误差不超过 1%
+    return static_cast<int>(std::lround(2.0 * std::pow(kGamma, bucket - 1) / (kGamma + 1.0)));
+}
+
+int64_t ScoreSketch::countBelow(int bucket) const {
+    int64_t sum = 0;
+    for (int i = bucket; i > 0; i -= i & -i) {
+        sum += tree_[i];
+    }
+    return sum;
+}
@@ -0,0 +1,504 @@
+#include "SmallSolver.h"
+#include "BoardBatch.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const double kTwoProbability = 0.9;
+const size_t kBatchChunk = 4096;   // 批量内核每次处理的局面数
+
+static_assert(sizeof(SmallSolution) == 32, "SmallSolution must stay 32 bytes");
+
+double elapsedSeconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 向右/向下移动前把区域平移到右/下边缘所需的位移（位数）
+int shiftFor(Direction dir, int rows, int cols) {
+    if (dir == Direction::RIGHT) return 4 * (4 - cols);
+    if (dir == Direction::DOWN) return 16 * (4 - rows);
+    return 0;
+}
+
+// 把 [begin, end) 均分给各线程；局面少时不开线程
+template <typename Fn>
+void parallelFor(size_t count, int threads, Fn fn) {
+    if (threads <= 1 || count < 1024) {
+        fn(0, count, 0);
+        return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        size_t begin = t * chunk;
+        size_t end = std::min(count, begin + chunk);
+        if (begin >= end) break;
+        workers.emplace_back(fn, begin, end, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// 一层的键文件和结果文件（只读映射）
+struct LayerView {
+    MappedFile keysFile;
+    MappedFile solutionFile;
+    const uint64_t* keys = nullptr;
+    const SmallSolution* solutions = nullptr;
+    size_t count = 0;
+    
+    bool open(const std::string& keysPath, const std::string& solutionPath) {
+        if (!keysFile.open(keysPath) || keysFile.size() % sizeof(uint64_t) != 0) {
+            return false;
+        }
+        keys = reinterpret_cast<const uint64_t*>(keysFile.data());
+        count = keysFile.size() / sizeof(uint64_t);
+        if (!solutionPath.empty()) {
+            if (!solutionFile.open(solutionPath) || solutionFile.size() != count * sizeof(SmallSolution)) {
+                return false;
+            }
+            solutions = reinterpret_cast<const SmallSolution*>(solutionFile.data());
+        }
+        return true;
+    }
+    
+    const SmallSolution* find(uint64_t key) const {
+        const uint64_t* it = std::lower_bound(keys, keys + count, key);
+        return (it != keys + count && *it == key) ? &solutions[it - keys] : nullptr;
+    }
+};
+
+// 一个线程展开一段局面的输出：新方块为2和为4的子局面分别去往总和+2、+4两层
+struct ExpandOutput {
+    std::vector<uint64_t> children[2];
+    uint64_t moves = 0;
+    uint64_t mismatches = 0;
+};
+
+void addChildren(const SmallSolver& solver, uint64_t after, ExpandOutput& out) {
+    for (int row = 0; row < solver.rows(); ++row) {
+        for (int col = 0; col < solver.cols(); ++col) {
+            int i = row * 4 + col;
+            if (((after >> (4 * i)) & 0xf) != 0) continue;
+            out.children[0].push_back(solver.canonical(after | (1ULL << (4 * i))));
+            out.children[1].push_back(solver.canonical(after | (2ULL << (4 * i))));
+        }
+    }
+}
+
+void expandScalar(const SmallSolver& solver, const uint64_t* states, size_t count, ExpandOutput& out) {
+    for (size_t k = 0; k < count; ++k) {
+        for (int d = 0; d < 4; ++d) {
+            uint64_t after = solver.move(states[k], static_cast<Direction>(d));
+            if (after != states[k]) {
+                addChildren(solver, after, out);
+            }
+        }
+    }
+    out.moves += count * 4;
+}
+
+// 批量内核：一次对几千个局面做同一方向的移动，再逐个与 movePacked 的结果核对
+void expandBatch(const SmallSolver& solver, const uint64_t* states, size_t count, ExpandOutput& out) {
+    BoardBatch batch(kBatchChunk);
+    for (size_t base = 0; base < count; base += kBatchChunk) {
+        size_t n = std::min(kBatchChunk, count - base);
+        if (n != batch.size()) {
+            batch.resize(n);
+        }
+        for (int d = 0; d < 4; ++d) {
+            Direction dir = static_cast<Direction>(d);
+            int shift = shiftFor(dir, solver.rows(), solver.cols());
+            for (size_t k = 0; k < n; ++k) {
+                batch.set(k, states[base + k] << shift);
+            }
+            batch.move(dir);
+            for (size_t k = 0; k < n; ++k) {
+                uint64_t state = states[base + k];
+                uint64_t after = batch.get(k) >> shift;
+                int gain = 0;
+                if (solver.move(state, dir, &gain) != after || batch.changed(k) != (after != state) ||
+                    static_cast<int>(batch.gain(k)) != gain) {
+                    ++out.mismatches;
+                }
+                if (batch.changed(k)) {
+                    addChildren(solver, after, out);
+                }
+            }
+        }
+        out.moves += n * 4;
+    }
+}
+
+// 对一个局面的四个方向求三种策略下的值：即时得分 + 新方块的期望（子局面在总和+2、+4两层中查找）
+struct MoveValues {
+    bool legal[4];
+    int gain[4];
+    int empty[4];
+    double optimal[4];
+    double greedy[4];
+    double random[4];
+};
+
+void evaluateMoves(const SmallSolver& solver, uint64_t state, const LayerView* next2, const LayerView* next4,
+                   MoveValues& values, uint64_t& misses) {
+    for (int d = 0; d < 4; ++d) {
+        int gain = 0;
+        uint64_t after = solver.move(state, static_cast<Direction>(d), &gain);
+        values.legal[d] = after != state;
+        values.gain[d] = gain;
+        values.empty[d] = 0;
+        values.optimal[d] = values.greedy[d] = values.random[d] = 0.0;
+        if (!values.legal[d]) continue;
+        
+        double optimal = 0.0, greedy = 0.0, random = 0.0;
+        int empty = 0;
+        for (int row = 0; row < solver.rows(); ++row) {
+            for (int col = 0; col < solver.cols(); ++col) {
+                int i = row * 4 + col;
+                if (((after >> (4 * i)) & 0xf) != 0) continue;
+                ++empty;
+                for (uint64_t tile = 1; tile <= 2; ++tile) {
+                    const LayerView* layer = tile == 1 ? next2 : next4;
+                    const SmallSolution* child = layer ? layer->find(solver.canonical(after | (tile << (4 * i)))) : nullptr;
+                    if (child == nullptr) {
+                        ++misses;
+                        continue;
+                    }
+                    double p = tile == 1 ? kTwoProbability : 1.0 - kTwoProbability;
+                    optimal += p * child->optimal;
+                    greedy += p * child->greedy;
+                    random += p * child->random;
+                }
+            }
+        }
+        values.empty[d] = empty;
+        values.optimal[d] = gain + optimal / empty;
+        values.greedy[d] = gain + greedy / empty;
+        values.random[d] = gain + random / empty;
+    }
+}
+
+SmallSolution solveState(const MoveValues& values) {
+    SmallSolution solution = {};
+    solution.dir = 0xff;
+    int best = -1, greedy = -1, legal = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (!values.legal[d]) continue;
+        ++legal;
+        if (best < 0 || values.optimal[d] > values.optimal[best]) {
+            best = d;
+        }
+        if (greedy < 0 || values.gain[d] > values.gain[greedy] ||
+            (values.gain[d] == values.gain[greedy] && values.empty[d] > values.empty[greedy])) {
+            greedy = d;
+        }
+        solution.random += values.random[d];
+    }
+    if (legal == 0) {
+        return solution;   // 游戏结束，之后不再得分
+    }
+    solution.optimal = values.optimal[best];
+    solution.greedy = values.greedy[greedy];
+    solution.random /= legal;
+    solution.dir = static_cast<uint8_t>(best);
+    return solution;
+}
+
+template <typename T>
+bool writeArray(const std::string& path, const std::vector<T>& data, bool append) {
+    std::ofstream file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));
+    return !file.fail();
+}
+
+bool readArray(const std::string& path, std::vector<uint64_t>& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    data.resize(static_cast<size_t>(size) / sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(uint64_t)));
+    return !file.fail();
+}
+
+} // namespace
+
+SmallSolver::SmallSolver(int rows, int cols)
+    : rows_(rows),
+      cols_(cols),
+      threads_(1),
+      useBatch_(false),
+      workDir_("solver") {
+}
+
+bool SmallSolver::isValid() const {
+    // 4x4 的状态空间无法枚举；至少一边小于4
+    return rows_ >= 2 && rows_ <= 4 && cols_ >= 2 && cols_ <= 4 && rows_ * cols_ <= 12;
+}
+
+void SmallSolver::setThreads(int threads) {
+    threads_ = std::max(1, threads);
+}
+
+void SmallSolver::setWorkDir(const std::string& dir) {
+    workDir_ = dir;
+}
+
+void SmallSolver::setUseBatch(bool useBatch) {
+    useBatch_ = useBatch;
+}
+
+std::string SmallSolver::keysPath(int sum) const {
+    return workDir_ + "/s" + std::to_string(sum) + ".keys";
+}
+
+std::string SmallSolver::solutionPath(int sum) const {
+    return workDir_ + "/s" + std::to_string(sum) + ".sol";
+}
+
+std::string SmallSolver::pendingPath(int sum) const {
+    return workDir_ + "/s" + std::to_string(sum) + ".pending";
+}
+
+uint64_t SmallSolver::move(uint64_t packed, Direction dir, int* scoreGain) const {
+    int shift = shiftFor(dir, rows_, cols_);
+    return Board::movePacked(packed << shift, dir, scoreGain) >> shift;
+}
+
+uint64_t SmallSolver::canonical(uint64_t packed) const {
+    // 镜像/翻转后区域落在右/下边缘，平移回左上角
+    int colShift = 4 * (4 - cols_);
+    int rowShift = 16 * (4 - rows_);
+    uint64_t m = Board::mirror(packed) >> colShift;
+    uint64_t f = Board::flip(packed) >> rowShift;
+    uint64_t mf = Board::flip(m) >> rowShift;
+    uint64_t best = std::min(std::min(packed, m), std::min(f, mf));
+    if (rows_ == cols_) {
+        uint64_t t = std::min(std::min(Board::transpose(packed), Board::transpose(m)),
+                              std::min(Board::transpose(f), Board::transpose(mf)));
+        best = std::min(best, t);
+    }
+    return best;
+}
+
+int SmallSolver::tileSum(uint64_t packed) {
+    int sum = 0;
+    for (int i = 0; i < 16; ++i) {
+        int value = static_cast<int>((packed >> (4 * i)) & 0xf);
+        sum += value ? 1 << value : 0;
+    }
+    return sum;
+}
+
+bool SmallSolver::run(SmallSolverResult& result) {
+    result = SmallSolverResult();
+    if (!isValid()) {
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(workDir_, error);
+    return expand(result) && solve(result) && initialScores(result);
+}
+
+bool SmallSolver::expand(SmallSolverResult& result) {
+    auto start = Clock::now();
+    layerSums_.clear();
+    
+    // 清掉上次运行留下的文件，待展开层的文件是追加写入的
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(workDir_, error)) {
+        std::string ext = entry.path().extension().string();
+        if (ext == ".keys" || ext == ".sol" || ext == ".pending") {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+    
+    // 初始局面：区域内任意两格各放一个2或4
+    std::set<int> pending;
+    std::vector<uint64_t> initial[3];
+    for (int a = 0; a < 16; ++a) {
+        for (int b = a + 1; b < 16; ++b) {
+            if (a % 4 >= cols_ || a / 4 >= rows_ || b % 4 >= cols_ || b / 4 >= rows_) continue;
+            for (uint64_t ta = 1; ta <= 2; ++ta) {
+                for (uint64_t tb = 1; tb <= 2; ++tb) {
+                    initial[ta + tb - 2].push_back(canonical((ta << (4 * a)) | (tb << (4 * b))));
+                }
+            }
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        int sum = 4 + 2 * k;
+        if (!writeArray(pendingPath(sum), initial[k], false)) {
+            return false;
+        }
+        pending.insert(sum);
+    }
+    
+    std::vector<ExpandOutput> outputs(threads_);
+    while (!pending.empty()) {
+        int sum = *pending.begin();
+        pending.erase(pending.begin());
+        
+        // 轮到该层时它的所有来源（总和-2、-4两层）都已展开：排序去重后写成有序键文件
+        std::vector<uint64_t> states;
+        if (!readArray(pendingPath(sum), states)) {
+            return false;
+        }
+        std::filesystem::remove(pendingPath(sum), error);
+        std::sort(states.begin(), states.end());
+        states.erase(std::unique(states.begin(), states.end()), states.end());
+        if (!writeArray(keysPath(sum), states, false)) {
+            return false;
+        }
+        layerSums_.push_back(sum);
+        result.states += states.size();
+        result.largestLayer = std::max<uint64_t>(result.largestLayer, states.size());
+        
+        // 并行展开本层，各线程先在本地去重，再追加到目标层的文件
+        for (auto& output : outputs) {
+            output.children[0].clear();
+            output.children[1].clear();
+        }
+        parallelFor(states.size(), threads_, [&](size_t begin, size_t end, int thread) {
+            ExpandOutput& output = outputs[thread];
+            if (useBatch_) {
+                expandBatch(*this, states.data() + begin, end - begin, output);
+            } else {
+                expandScalar(*this, states.data() + begin, end - begin, output);
+            }
+            for (auto& children : output.children) {
+                std::sort(children.begin(), children.end());
+                children.erase(std::unique(children.begin(), children.end()), children.end());
+            }
+        });
+        for (auto& output : outputs) {
+            for (int tile = 0; tile < 2; ++tile) {
+                if (output.children[tile].empty()) continue;
+                int target = sum + 2 * (tile + 1);
+                if (!writeArray(pendingPath(target), output.children[tile], true)) {
+                    return false;
+                }
+                pending.insert(target);
+            }
+        }
+    }
+    
+    for (const auto& output : outputs) {
+        result.moves += output.moves;
+        result.kernelMismatches += output.mismatches;
+    }
+    result.layers = static_cast<int>(layerSums_.size());
+    result.expandSeconds = elapsedSeconds(start);
+    return true;
+}
+
+bool SmallSolver::solve(SmallSolverResult& result) {
+    auto start = Clock::now();
+    
+    // 从总和最大的层往回算；总和+2、+4两层的结果已经写好
+    for (auto it = layerSums_.rbegin(); it != layerSums_.rend(); ++it) {
+        int sum = *it;
+        LayerView current;
+        if (!current.open(keysPath(sum), "")) {
+            return false;
+        }
+        std::unique_ptr<LayerView> next2, next4;
+        if (std::binary_search(layerSums_.begin(), layerSums_.end(), sum + 2)) {
+            next2.reset(new LayerView());
+            if (!next2->open(keysPath(sum + 2), solutionPath(sum + 2))) return false;
+        }
+        if (std::binary_search(layerSums_.begin(), layerSums_.end(), sum + 4)) {
+            next4.reset(new LayerView());
+            if (!next4->open(keysPath(sum + 4), solutionPath(sum + 4))) return false;
+        }
+        
+        std::vector<SmallSolution> solutions(current.count);
+        std::vector<uint64_t> misses(threads_, 0);
+        parallelFor(current.count, threads_, [&](size_t begin, size_t end, int thread) {
+            MoveValues values;
+            for (size_t k = begin; k < end; ++k) {
+                evaluateMoves(*this, current.keys[k], next2.get(), next4.get(), values, misses[thread]);
+                solutions[k] = solveState(values);
+            }
+        });
+        for (uint64_t miss : misses) {
+            if (miss > 0) {
+                return false;   // 子局面不在展开结果里，说明展开与求值用的移动规则不一致
+            }
+        }
+        if (!writeArray(solutionPath(sum), solutions, false)) {
+            return false;
+        }
+    }
+    result.solveSeconds = elapsedSeconds(start);
+    return true;
+}
+
+bool SmallSolver::initialScores(SmallSolverResult& result) const {
+    LayerView layers[3];
+    for (int k = 0; k < 3; ++k) {
+        if (!layers[k].open(keysPath(4 + 2 * k), solutionPath(4 + 2 * k))) {
+            return false;
+        }
+    }
+    
+    // 与 Board::init 相同：先在所有格子中均匀选一格，再在剩下的格子中选一格，各自 0.9 为2、0.1 为4
+    double cells = rows_ * cols_;
+    for (int a = 0; a < 16; ++a) {
+        for (int b = 0; b < 16; ++b) {
+            if (a == b || a % 4 >= cols_ || a / 4 >= rows_ || b % 4 >= cols_ || b / 4 >= rows_) continue;
+            for (uint64_t ta = 1; ta <= 2; ++ta) {
+                for (uint64_t tb = 1; tb <= 2; ++tb) {
+                    double p = (ta == 1 ? kTwoProbability : 1.0 - kTwoProbability) *
+                               (tb == 1 ? kTwoProbability : 1.0 - kTwoProbability) / (cells * (cells - 1));
+                    const SmallSolution* solution =
+                        layers[ta + tb - 2].find(canonical((ta << (4 * a)) | (tb << (4 * b))));
+                    if (solution == nullptr) {
+                        return false;
+                    }
+                    result.optimalScore += p * solution->optimal;
+                    result.greedyScore += p * solution->greedy;
+                    result.randomScore += p * solution->random;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool SmallSolver::bestMove(uint64_t packed, Direction& dir, double* value) const {
+    int sum = tileSum(packed);
+    LayerView next2, next4;
+    bool has2 = next2.open(keysPath(sum + 2), solutionPath(sum + 2));
+    bool has4 = next4.open(keysPath(sum + 4), solutionPath(sum + 4));
+    
+    MoveValues values;
+    uint64_t misses = 0;
+    evaluateMoves(*this, packed, has2 ? &next2 : nullptr, has4 ? &next4 : nullptr, values, misses);
+    SmallSolution solution = solveState(values);
+    if (misses > 0 || solution.dir == 0xff) {
+        return false;
+    }
+    dir = static_cast<Direction>(solution.dir);
+    if (value) {
+        *value = solution.optimal;
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#include "StringPool.h"
+
+StringPool::StringPool() : offsets_(1, 0), slots_(16, 0) {
+}
+
+void StringPool::reserve(size_t strings, size_t bytes) {
+    chars_.reserve(bytes);
+    offsets_.reserve(strings + 1);
+    
+    // 负载因子保持在一半以下
+    size_t slotCount = slots_.size();
+    while (slotCount < strings * 2) {
+        slotCount *= 2;
+    }
+    if (slotCount != slots_.size()) {
+        rehash(slotCount);
+    }
+}
+
+uint32_t StringPool::intern(std::string_view str) {
+    uint64_t h = hash(str);
+    size_t slot = findSlot(str, h);
+    if (slots_[slot] != 0) {
+        return slots_[slot] - 1;
+    }
+    
+    uint32_t id = static_cast<uint32_t>(size());
+    chars_.insert(chars_.end(), str.begin(), str.end());
+    offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+    slots_[slot] = id + 1;
+    
+    if (size() * 2 > slots_.size()) {
+        rehash(slots_.size() * 2);
+    }
+    
+    return id;
+}
+
+uint32_t StringPool::find(std::string_view str) const {
+    size_t slot = findSlot(str, hash(str));
+    return slots_[slot] == 0 ? npos : slots_[slot] - 1;
+}
+
+std::string_view StringPool::get(uint32_t id) const {
+    return std::string_view(chars_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]);
+}
+
+void StringPool::clear() {
+    chars_.clear();
+    offsets_.assign(1, 0);
+    slots_.assign(16, 0);
+}
+
+uint64_t StringPool::hash(std::string_view str) {
+    // FNV-1a
+    uint64_t h = 14695981039346656037ull;
+    for (char c : str) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+size_t StringPool::findSlot(std::string_view str, uint64_t h) const {
+    size_t mask = slots_.size() - 1;
+    size_t slot = static_cast<size_t>(h) & mask;
+    
+    // 线性探测：返回命中的槽或第一个空槽
+    while (slots_[slot] != 0 && get(slots_[slot] - 1) != str) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void StringPool::rehash(size_t slotCount) {
+    slots_.assign(slotCount, 0);
+    size_t mask = slotCount - 1;
+    
+    for (uint32_t id = 0; id < size(); ++id) {
+        size_t slot = static_cast<size_t>(hash(get(id))) & mask;
+        while (slots_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = id + 1;
+    }
+}
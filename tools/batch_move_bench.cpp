@@ -0,0 +1,124 @@
+// 批量移动基准：从随机对局中取局面装入 BoardBatch，逐个指令集实现测量每秒移动的局面数，
+// 并逐个局面与 Board::simulateMove 的结果（网格、得分、是否变化）核对
+// 用法: ./bin/batch_move_bench [局面数=4096] [轮数=2000]
+#include "Board.h"
+#include "BoardBatch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedSeconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 用 Board::simulateMove 算出期望结果
+static bool expectedMove(uint64_t packed, Direction dir, uint64_t& result, int& gain, bool& changed) {
+    Board board;
+    board.unpack(packed);
+    MoveResult move = board.simulateMove(dir);
+    Board after;
+    after.setGrid(move.grid);
+    gain = move.scoreGain;
+    changed = move.changed;
+    return after.pack(result);
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    
+    // 采样：随机对局中途的局面
+    std::mt19937 rng(42);
+    std::vector<uint64_t> positions;
+    while (positions.size() < count) {
+        Board board;
+        board.init(rng());
+        while (!board.isGameOver() && positions.size() < count) {
+            board.applyMove(static_cast<Direction>(rng() % 4));
+            uint64_t packed;
+            if (rng() % 4 == 0 && board.pack(packed)) {
+                positions.push_back(packed);
+            }
+        }
+    }
+    
+    BoardBatch source(count);
+    for (size_t k = 0; k < count; ++k) {
+        source.set(k, positions[k]);
+    }
+    std::printf("局面数: %zu  轮数: %zu  自动选择: %s\n", count, rounds,
+                BoardBatch::kernelName(BoardBatch::bestKernel()));
+    
+    // 参照：逐个局面调用 Board::simulateMove
+    auto start = Clock::now();
+    size_t sink = 0;
+    size_t referenceRounds = rounds / 20 + 1;
+    Board board;
+    for (size_t r = 0; r < referenceRounds; ++r) {
+        Direction dir = static_cast<Direction>(r % 4);
+        for (size_t k = 0; k < count; ++k) {
+            board.unpack(positions[k]);
+            sink += static_cast<size_t>(board.simulateMove(dir).scoreGain);
+        }
+    }
+    double referenceRate = referenceRounds * count / elapsedSeconds(start);
+    std::printf("%-8s %8.2f 百万局面/秒（含 unpack）\n", "simulateMove", referenceRate / 1e6);
+    
+    // 参照：Board::movePacked 查表
+    start = Clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        Direction dir = static_cast<Direction>(r % 4);
+        for (size_t k = 0; k < count; ++k) {
+            int gain;
+            sink += Board::movePacked(positions[k], dir, &gain) & 1;
+        }
+    }
+    std::printf("%-8s %8.2f 百万局面/秒\n", "movePacked", rounds * count / elapsedSeconds(start) / 1e6);
+    
+    int failures = 0;
+    double scalarRate = 0.0;
+    for (BatchKernel kernel : {BatchKernel::SCALAR, BatchKernel::SSE41, BatchKernel::AVX2}) {
+        if (!BoardBatch::isSupported(kernel)) {
+            std::printf("%-8s 本机不支持\n", BoardBatch::kernelName(kernel));
+            continue;
+        }
+        
+        // 正确性：四个方向各核对一遍
+        size_t mismatches = 0;
+        BoardBatch batch(count);
+        for (int d = 0; d < 4; ++d) {
+            batch = source;
+            batch.move(static_cast<Direction>(d), kernel);
+            for (size_t k = 0; k < count; ++k) {
+                uint64_t result;
+                int gain;
+                bool changed;
+                if (!expectedMove(positions[k], static_cast<Direction>(d), result, gain, changed) ||
+                    batch.get(k) != result || static_cast<int>(batch.gain(k)) != gain || batch.changed(k) != changed) {
+                    ++mismatches;
+                }
+            }
+        }
+        
+        // 吞吐：每轮先恢复原局面（16 x 局面数字节的拷贝）再移动，方向轮换
+        start = Clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            batch = source;
+            sink += batch.move(static_cast<Direction>(r % 4), kernel);
+        }
+        double rate = rounds * count / elapsedSeconds(start);
+        if (kernel == BatchKernel::SCALAR) {
+            scalarRate = rate;
+        }
+        std::printf("%-8s %8.2f 百万局面/秒  相对标量 %5.2fx  不一致: %zu\n", BoardBatch::kernelName(kernel),
+                    rate / 1e6, scalarRate > 0 ? rate / scalarRate : 0.0, mismatches);
+        failures += mismatches > 0 ? 1 : 0;
+    }
+    volatile size_t keep = sink;  // 防止计时循环被优化掉
+    (void)keep;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// 局面哈希与规范形式基准：随机策略打N局，校验增量哈希与重算一致、规范形式在8种对称下不变，
+// 测量两种操作的吞吐，并对比置换表用原始键/规范键时的命中率
+// 用法: ./bin/board_hash_bench [局数=2000]
+#include "Board.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 一个局面的全部8种对称
+static void symmetries(uint64_t packed, uint64_t out[8]) {
+    uint64_t m = Board::mirror(packed);
+    uint64_t f = Board::flip(packed);
+    uint64_t mf = Board::flip(m);
+    uint64_t base[4] = {packed, m, f, mf};
+    for (int i = 0; i < 4; ++i) {
+        out[i] = base[i];
+        out[i + 4] = Board::transpose(base[i]);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t games = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    
+    std::mt19937 rng(42);
+    std::vector<uint64_t> positions;
+    size_t hashMismatches = 0;
+    
+    // 采样：随机对局中的每个局面，同时测量增量哈希（applyMove 内含移动和生成方块）
+    auto start = Clock::now();
+    size_t moves = 0;
+    uint64_t sink = 0;
+    for (size_t g = 0; g < games; ++g) {
+        Board board;
+        board.init(rng());
+        while (!board.isGameOver()) {
+            if (board.applyMove(static_cast<Direction>(rng() % 4))) {
+                ++moves;
+                sink ^= board.hash();
+                uint64_t packed;
+                if (board.pack(packed)) {
+                    positions.push_back(packed);
+                    if (board.hash() != Board::hashOf(packed)) {
+                        ++hashMismatches;
+                    }
+                }
+            }
+        }
+    }
+    double playMs = elapsedMs(start);
+    std::printf("局数: %zu  局面数: %zu  对局+增量哈希: %.1f ms（%.2f 百万步/秒）  哈希不一致: %zu\n",
+                games, positions.size(), playMs, moves / playMs / 1000.0, hashMismatches);
+    
+    // 从紧凑表示完整计算哈希的吞吐
+    start = Clock::now();
+    for (uint64_t packed : positions) {
+        sink ^= Board::hashOf(packed);
+    }
+    double hashMs = elapsedMs(start);
+    
+    // 规范形式吞吐
+    start = Clock::now();
+    for (uint64_t packed : positions) {
+        sink ^= Board::canonical(packed);
+    }
+    double canonMs = elapsedMs(start);
+    std::printf("完整哈希: %.2f 百万次/秒  规范形式: %.2f 百万次/秒\n",
+                positions.size() / hashMs / 1000.0, positions.size() / canonMs / 1000.0);
+    volatile uint64_t keep = sink;  // 防止计时循环被优化掉
+    (void)keep;
+    
+    // 正确性：8种对称的规范形式相同
+    size_t canonMismatches = 0;
+    for (size_t i = 0; i < positions.size(); i += 7) {
+        uint64_t sym[8];
+        symmetries(positions[i], sym);
+        uint64_t expected = Board::canonical(positions[i]);
+        for (uint64_t s : sym) {
+            if (Board::canonical(s) != expected) {
+                ++canonMismatches;
+            }
+        }
+    }
+    
+    // 命中率：每个局面随机取一种对称再查表，模拟搜索中从不同方向到达等价局面
+    std::unordered_set<uint64_t> rawTable;
+    std::unordered_set<uint64_t> canonTable;
+    size_t rawHits = 0;
+    size_t canonHits = 0;
+    for (uint64_t packed : positions) {
+        uint64_t sym[8];
+        symmetries(packed, sym);
+        uint64_t key = sym[rng() % 8];
+        rawHits += !rawTable.insert(key).second;
+        canonHits += !canonTable.insert(Board::canonical(key)).second;
+    }
+    std::printf("置换表命中率: 原始键 %.2f%%  规范键 %.2f%%  不同局面 原始 %zu / 规范 %zu  对称不一致: %zu\n",
+                100.0 * rawHits / positions.size(), 100.0 * canonHits / positions.size(),
+                rawTable.size(), canonTable.size(), canonMismatches);
+    
+    return hashMismatches == 0 && canonMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+// n元组网络 TD(0) 自对弈训练：多线程共享同一份权重，不加锁更新（Hogwild）
+// 每步按 即时得分 + 后状态估值 贪心选方向，用下一步的估值更新上一个后状态
+// 用法: ./bin/ntuple_train [线程数=1] [局数=10000] [输出=ntuple.bin] [small]
+//       ./bin/ntuple_train --scaling [每档秒数=3] [small]   # 1~32线程吞吐对比
+#include "Board.h"
+#include "NTupleNetwork.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const float kLearningRate = 0.1f;
+static const int kReportInterval = 1000;   // 每多少局打印一次进度
+
+struct TrainStats {
+    std::atomic<uint64_t> games{0};
+    std::atomic<uint64_t> moves{0};
+    std::atomic<uint64_t> scoreSum{0};
+    std::atomic<uint64_t> reached2048{0};
+};
+
+// 训练一局，返回分数
+static int trainGame(NTupleNetwork& net, uint64_t& rng, float alpha, int& maxLog, uint64_t& moves) {
+    uint64_t board = Board::spawnPacked(Board::spawnPacked(0, rng), rng);
+    uint64_t prevAfter = 0;
+    bool hasPrev = false;
+    int score = 0;
+    
+    Direction dir;
+    float value;
+    while (net.bestMove(board, dir, &value)) {
+        int gain = 0;
+        uint64_t after = Board::movePacked(board, dir, &gain);
+        if (hasPrev) {
+            net.update(prevAfter, alpha * (value - net.evaluate(prevAfter)));
+        }
+        prevAfter = after;
+        hasPrev = true;
+        score += gain;
+        ++moves;
+        board = Board::spawnPacked(after, rng);
+    }
+    // 终局的后状态价值为0
+    if (hasPrev) {
+        net.update(prevAfter, alpha * (0.0f - net.evaluate(prevAfter)));
+    }
+    
+    maxLog = 0;
+    for (int i = 0; i < 16; ++i) {
+        maxLog = std::max(maxLog, static_cast<int>((board >> (4 * i)) & 0xf));
+    }
+    return score;
+}
+
+// 工作线程：领取局号直到达到 totalGames 或 stop 置位
+static void worker(NTupleNetwork& net, TrainStats& stats, uint64_t seed, uint64_t totalGames,
+                   std::atomic<uint64_t>& nextGame, const std::atomic<bool>& stop) {
+    uint64_t rng = seed;
+    float alpha = kLearningRate / net.featureCount();
+    while (!stop.load(std::memory_order_relaxed) && nextGame.fetch_add(1) < totalGames) {
+        int maxLog = 0;
+        uint64_t moves = 0;
+        int score = trainGame(net, rng, alpha, maxLog, moves);
+        stats.moves.fetch_add(moves, std::memory_order_relaxed);
+        stats.scoreSum.fetch_add(static_cast<uint64_t>(score), std::memory_order_relaxed);
+        if (maxLog >= 11) {
+            stats.reached2048.fetch_add(1, std::memory_order_relaxed);
+        }
+        stats.games.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static int train(int threads, uint64_t games, const std::string& output, bool small) {
+    NTupleNetwork net;
+    bool resumed = net.load(output);
+    if (!resumed && !net.create(small ? NTupleNetwork::smallTuples() : NTupleNetwork::defaultTuples())) {
+        std::fprintf(stderr, "无法创建网络\n");
+        return 1;
+    }
+    std::printf("%s %s：%d 个元组，权重 %.1f MB，%d 线程，%llu 局\n", resumed ? "继续训练" : "新建网络",
+                output.c_str(), net.tupleCount(), net.weightCount() * sizeof(float) / 1048576.0, threads,
+                static_cast<unsigned long long>(games));
+    
+    TrainStats stats;
+    std::atomic<uint64_t> nextGame{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> pool;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back(worker, std::ref(net), std::ref(stats), Board::randomSeed() + t, games,
+                          std::ref(nextGame), std::cref(stop));
+    }
+    
+    // 主线程按区间打印进度：区间内的平均分和2048达成率
+    uint64_t lastGames = 0, lastScore = 0, last2048 = 0;
+    while (lastGames < games) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        uint64_t done = stats.games.load();
+        if (done - lastGames < kReportInterval && done < games) {
+            continue;
+        }
+        uint64_t score = stats.scoreSum.load();
+        uint64_t reached = stats.reached2048.load();
+        uint64_t interval = done - lastGames;
+        if (interval > 0) {
+            double elapsed = secondsSince(start);
+            std::printf("%8llu 局  平均分 %8.0f  2048达成率 %5.1f%%  %.0f 局/秒（每线程 %.1f）\n",
+                        static_cast<unsigned long long>(done), static_cast<double>(score - lastScore) / interval,
+                        100.0 * (reached - last2048) / interval, done / elapsed, done / elapsed / threads);
+            std::fflush(stdout);
+        }
+        lastGames = done;
+        lastScore = score;
+        last2048 = reached;
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    if (!net.saveTo(output)) {
+        std::fprintf(stderr, "保存失败: %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("已保存 %s（%.1f 秒）\n", output.c_str(), secondsSince(start));
+    return 0;
+}
+
+// 吞吐扩展性：每档线程数从全零网络开始跑固定秒数
+static int scaling(double seconds, bool small) {
+    std::printf("硬件线程数: %u\n", std::thread::hardware_concurrency());
+    std::printf("%6s %10s %12s %12s %8s\n", "线程", "局/秒", "每线程局/秒", "百万步/秒", "加速比");
+    double baseline = 0.0;
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        NTupleNetwork net;
+        if (!net.create(small ? NTupleNetwork::smallTuples() : NTupleNetwork::defaultTuples())) {
+            return 1;
+        }
+        TrainStats stats;
+        std::atomic<uint64_t> nextGame{0};
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> pool;
+        auto start = Clock::now();
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back(worker, std::ref(net), std::ref(stats), 1234 + t, UINT64_MAX,
+                              std::ref(nextGame), std::cref(stop));
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop.store(true);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        double elapsed = secondsSince(start);
+        double gamesPerSec = stats.games.load() / elapsed;
+        if (threads == 1) {
+            baseline = gamesPerSec;
+        }
+        std::printf("%6d %10.1f %12.1f %12.2f %8.2f\n", threads, gamesPerSec, gamesPerSec / threads,
+                    stats.moves.load() / elapsed / 1e6, baseline > 0 ? gamesPerSec / baseline : 0.0);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    bool small = argc > 1 && std::strcmp(argv[argc - 1], "small") == 0;
+    if (small) {
+        --argc;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--scaling") == 0) {
+        return scaling(argc > 2 ? std::atof(argv[2]) : 3.0, small);
+    }
+    
+    int threads = argc > 1 ? std::atoi(argv[1]) : 1;
+    uint64_t games = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+    std::string output = argc > 3 ? argv[3] : "ntuple.bin";
+    return train(threads < 1 ? 1 : threads, games, output, small);
+}
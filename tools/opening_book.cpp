@@ -0,0 +1,207 @@
+// 开局库生成：枚举前K步可能出现的所有局面（两个初始方块的所有放法起，每步所有方向 x 所有新方块），
+// 按8种对称合并后逐个做期望最大化搜索，把最佳方向、期望得分和置信度写入有序的二进制文件
+// 有 ntuple.bin 时叶子用网络估值
+// 用法: ./bin/opening_book [线程数=1] [步数K=4] [搜索深度=2] [输出=opening.bin] [sorted]
+//       ./bin/opening_book --bench [文件=opening.bin] [查询次数=2000000]   # 查询吞吐，并核对对称换算
+#include "Board.h"
+#include "HintSearch.h"
+#include "NTupleNetwork.h"
+#include "OpeningBook.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedSeconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 按层展开：第0层是所有初始局面，之后每层对上一层的每个局面走所有合法方向、放所有可能的新方块
+// 返回所有层的局面（最小表示，去重，不含无法移动的局面）
+static std::vector<uint64_t> enumeratePositions(int plies) {
+    std::unordered_set<uint64_t> seen;
+    std::vector<uint64_t> level;
+    for (int a = 0; a < 16; ++a) {
+        for (int b = a + 1; b < 16; ++b) {
+            for (uint64_t ta = 1; ta <= 2; ++ta) {
+                for (uint64_t tb = 1; tb <= 2; ++tb) {
+                    uint64_t board = Board::canonical((ta << (4 * a)) | (tb << (4 * b)));
+                    if (seen.insert(board).second) {
+                        level.push_back(board);
+                    }
+                }
+            }
+        }
+    }
+    std::printf("第0层: %zu 个局面\n", level.size());
+    
+    std::vector<uint64_t> all = level;
+    for (int ply = 1; ply <= plies; ++ply) {
+        std::vector<uint64_t> next;
+        for (uint64_t board : level) {
+            for (int d = 0; d < 4; ++d) {
+                uint64_t after = Board::movePacked(board, static_cast<Direction>(d));
+                if (after == board) continue;
+                for (int i = 0; i < 16; ++i) {
+                    if (((after >> (4 * i)) & 0xf) != 0) continue;
+                    for (uint64_t tile = 1; tile <= 2; ++tile) {
+                        uint64_t child = Board::canonical(after | (tile << (4 * i)));
+                        if (seen.insert(child).second) {
+                            next.push_back(child);
+                        }
+                    }
+                }
+            }
+        }
+        std::printf("第%d层: %zu 个新局面\n", ply, next.size());
+        all.insert(all.end(), next.begin(), next.end());
+        level.swap(next);
+    }
+    return all;
+}
+
+static int build(int threadCount, int plies, int depth, const std::string& output, BookLayout layout) {
+    NTupleNetwork network;
+    const NTupleNetwork* evaluator = network.open("ntuple.bin") ? &network : nullptr;
+    std::printf("步数K=%d  搜索深度=%d  线程=%d  估值: %s  排列: %s\n", plies, depth, threadCount,
+                evaluator ? "ntuple.bin" : "启发式", layout == BookLayout::EYTZINGER ? "Eytzinger" : "有序数组");
+    
+    auto start = Clock::now();
+    std::vector<uint64_t> positions = enumeratePositions(plies);
+    std::printf("共 %zu 个局面（枚举 %.2f 秒）\n", positions.size(), elapsedSeconds(start));
+    
+    // 各线程按原子计数器领取局面，结果写到各自的下标，无需加锁
+    std::vector<BookRecord> records(positions.size());
+    std::vector<uint8_t> valid(positions.size(), 0);
+    std::atomic<size_t> nextIndex{0};
+    std::atomic<size_t> done{0};
+    start = Clock::now();
+    auto worker = [&]() {
+        size_t index;
+        while ((index = nextIndex.fetch_add(1)) < positions.size()) {
+            Hint hint;
+            float value = 0.0f;
+            if (HintSearch::search(positions[index], depth, evaluator, hint, &value)) {
+                BookRecord& record = records[index];
+                record.key = positions[index];
+                record.value = value;
+                record.dir = static_cast<uint8_t>(hint.dir);
+                record.confidence = static_cast<uint8_t>(hint.confidence);
+                record.depth = static_cast<uint8_t>(hint.depth);
+                record.reserved = 0;
+                valid[index] = 1;
+            }
+            size_t finished = done.fetch_add(1) + 1;
+            if (finished % 100000 == 0) {
+                std::printf("  已搜索 %zu / %zu（%.1f 秒）\n", finished, positions.size(), elapsedSeconds(start));
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    std::vector<BookRecord> book;
+    book.reserve(records.size());
+    for (size_t k = 0; k < records.size(); ++k) {
+        if (valid[k]) {
+            book.push_back(records[k]);
+        }
+    }
+    std::printf("搜索完成: %zu 条记录，%.2f 秒\n", book.size(), elapsedSeconds(start));
+    
+    if (!OpeningBook::write(output, book, layout, plies, depth)) {
+        std::fprintf(stderr, "无法写入 %s\n", output.c_str());
+        return 1;
+    }
+    size_t slots = book.size() + (layout == BookLayout::EYTZINGER ? 1 : 0);
+    std::printf("已写入 %s（%zu 字节）\n", output.c_str(), OpeningBook::HEADER_SIZE + slots * sizeof(BookRecord));
+    return 0;
+}
+
+static int bench(const std::string& path, size_t queries) {
+    auto start = Clock::now();
+    OpeningBook book;
+    book.open(path);
+    std::printf("open: %.1f 微秒（不读文件）\n", elapsedSeconds(start) * 1e6);
+    start = Clock::now();
+    if (!book.isAvailable()) {
+        std::fprintf(stderr, "无法读取开局库 %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("首次映射: %.1f 微秒  记录: %zu  K=%d  深度=%d  排列: %s\n", elapsedSeconds(start) * 1e6,
+                book.size(), book.plies(), book.depth(),
+                book.layout() == BookLayout::EYTZINGER ? "Eytzinger" : "有序数组");
+    
+    std::vector<uint64_t> keys = enumeratePositions(book.plies());
+    
+    // 查询局面：库内局面的随机对称变换（一半）和库外局面（较深的随机对局）
+    uint64_t rng = 12345;
+    std::vector<uint64_t> samples;
+    size_t mismatches = 0;
+    size_t inBook = 0;
+    for (size_t k = 0; k < 1 << 16; ++k) {
+        rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t key = keys[(rng >> 16) % keys.size()];
+        int symmetry = static_cast<int>(rng >> 61);
+        uint64_t board = key;
+        if (symmetry & 1) board = Board::mirror(board);
+        if (symmetry & 2) board = Board::flip(board);
+        if (symmetry & 4) board = Board::transpose(board);
+        samples.push_back(board);
+        
+        // 对称换算：两种朝向查到的方向，移动后应是同一局面（按对称）；无法移动的局面不在库里
+        BookMove a, b;
+        if (book.lookup(key, b) && !book.lookup(board, a)) {
+            ++mismatches;
+        } else if (book.lookup(key, b) &&
+            Board::canonical(Board::movePacked(board, a.dir)) != Board::canonical(Board::movePacked(key, b.dir))) {
+            ++mismatches;
+        }
+        
+        uint64_t outside = Board::spawnPacked(Board::spawnPacked(0, rng), rng);
+        for (int step = 0; step < book.plies() + 8; ++step) {
+            uint64_t after = Board::movePacked(outside, static_cast<Direction>(rng >> 62));
+            rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            outside = Board::spawnPacked(after, rng);
+        }
+        samples.push_back(outside);
+    }
+    
+    start = Clock::now();
+    BookMove move;
+    for (size_t q = 0; q < queries; ++q) {
+        inBook += book.lookup(samples[q & (samples.size() - 1)], move) ? 1 : 0;
+    }
+    double rate = queries / elapsedSeconds(start);
+    std::printf("查询: %.2f 百万次/秒（含求最小表示）  命中 %.1f%%  对称换算不一致: %zu\n",
+                rate / 1e6, 100.0 * inBook / queries, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        std::string path = argc > 2 ? argv[2] : "opening.bin";
+        size_t queries = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2000000;
+        return bench(path, queries);
+    }
+    
+    int threadCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1;
+    int plies = argc > 2 ? std::max(0, std::atoi(argv[2])) : 4;
+    int depth = argc > 3 ? std::max(1, std::atoi(argv[3])) : 2;
+    std::string output = argc > 4 ? argv[4] : "opening.bin";
+    BookLayout layout = argc > 5 && std::strcmp(argv[5], "sorted") == 0 ? BookLayout::SORTED : BookLayout::EYTZINGER;
+    return build(threadCount, plies, depth, output, layout);
+}
@@ -0,0 +1,96 @@
+// 策略基准：无界面对局比较各策略的平均分、最大方块分布和每秒步数
+// 每个策略分别以模板参数（内联）和 AnyPolicy（虚函数）各跑一遍，同一种子下结果必须完全相同
+// 用法: ./bin/policy_bench [局数=1000] [策略列表=greedy,corner,random,search]   # 有 ntuple.bin 时可加 ntuple
+#include "Board.h"
+#include "NTupleNetwork.h"
+#include "Policy.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchResult {
+    double seconds = 0.0;
+    uint64_t moves = 0;
+    uint64_t scoreSum = 0;
+    uint64_t checksum = 0;               // 各局分数和步数的混合，用于核对两种调用方式
+    std::map<int, int> maxTiles;
+};
+
+template <typename Policy>
+static BenchResult runGames(Policy& policy, int games) {
+    BenchResult result;
+    auto start = Clock::now();
+    for (int g = 0; g < games; ++g) {
+        GameOutcome outcome = playGame(policy, 0x9E3779B97F4A7C15ULL * (g + 1));
+        result.moves += outcome.moves;
+        result.scoreSum += outcome.score;
+        result.checksum = result.checksum * 31 + outcome.score * 1000003ULL + outcome.moves;
+        ++result.maxTiles[outcome.maxTile];
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+// 模板路径：按名字实例化具体类型
+static bool runTemplate(const std::string& name, const NTupleNetwork* network, int games, BenchResult& result) {
+    if (name == "greedy") {
+        GreedyPolicy policy;
+        result = runGames(policy, games);
+    } else if (name == "corner") {
+        CornerPolicy policy;
+        result = runGames(policy, games);
+    } else if (name == "random") {
+        RandomPolicy policy;
+        result = runGames(policy, games);
+    } else if (name == "search" || name == "search3") {
+        SearchPolicy policy(name == "search" ? 2 : 3, network);
+        result = runGames(policy, games);
+    } else if (name == "ntuple" && network) {
+        NTuplePolicy policy(*network);
+        result = runGames(policy, games);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int games = argc > 1 ? std::atoi(argv[1]) : 1000;
+    std::string list = argc > 2 ? argv[2] : "greedy,corner,random,search";
+    
+    NTupleNetwork network;
+    const NTupleNetwork* evaluator = network.open("ntuple.bin") ? &network : nullptr;
+    std::printf("局数: %d  估值网络: %s\n", games, evaluator ? "ntuple.bin" : "无");
+    
+    int failures = 0;
+    std::stringstream names(list);
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        BenchResult direct;
+        AnyPolicy erased = makePolicy(name, evaluator);
+        if (!erased || !runTemplate(name, evaluator, games, direct)) {
+            std::printf("%-10s 未知策略或缺少 ntuple.bin\n", name.c_str());
+            continue;
+        }
+        BenchResult virtualCall = runGames(erased, games);
+        
+        bool same = direct.checksum == virtualCall.checksum;
+        failures += same ? 0 : 1;
+        std::printf("%-18s 平均分 %9.1f  平均步数 %7.1f  模板 %7.2f 百万步/秒  AnyPolicy %7.2f 百万步/秒  %s\n",
+                    erased.name(), static_cast<double>(direct.scoreSum) / games,
+                    static_cast<double>(direct.moves) / games, direct.moves / direct.seconds / 1e6,
+                    virtualCall.moves / virtualCall.seconds / 1e6, same ? "结果一致" : "结果不一致!");
+        std::printf("%18s 最大方块:", "");
+        for (const auto& entry : direct.maxTiles) {
+            std::printf("  %d x%d", entry.first, entry.second);
+        }
+        std::printf("\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
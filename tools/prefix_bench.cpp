@@ -0,0 +1,72 @@
+// 用户名前缀补全基准：生成N个用户名的排行榜文件，加载后构建前缀索引并测量每次按键的查询耗时
+// 用法: ./bin/prefix_bench [用户名数=1000000] [查询次数=100000]
+#include "RankList.h"
+#include "PrefixIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t queries = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    const std::string path = "/tmp/prefix_bench_ranks.txt";
+    
+    std::mt19937 rng(42);
+    std::vector<std::string> names;
+    names.reserve(count);
+    {
+        std::ofstream file(path, std::ios::trunc);
+        for (size_t i = 0; i < count; ++i) {
+            std::string name;
+            size_t length = 4 + rng() % 7;
+            for (size_t c = 0; c < length; ++c) {
+                name += static_cast<char>((c == 0 && rng() % 4 == 0 ? 'A' : 'a') + rng() % 26);
+            }
+            name += std::to_string(i);  // 保证唯一
+            file << name << " " << rng() % 100000 << "\n";
+            names.push_back(name);
+        }
+    }
+    
+    RankList rankList(path);
+    auto start = Clock::now();
+    rankList.load();
+    std::printf("加载 %zu 条: %.1f ms\n", rankList.size(), elapsedMs(start));
+    
+    PrefixIndex index;
+    start = Clock::now();
+    index.build(rankList.snapshot());
+    std::printf("构建前缀索引: %.1f ms\n", elapsedMs(start));
+    
+    // 模拟逐字输入：取已有名字的前1~4个字符作为前缀
+    std::vector<double> latencies;
+    latencies.reserve(queries);
+    std::vector<RankEntryView> out;
+    size_t found = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        const std::string& name = names[rng() % names.size()];
+        std::string_view prefix(name.data(), 1 + rng() % 4);
+        auto t = Clock::now();
+        found += index.complete(prefix, 4, out);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t).count());
+    }
+    
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("查询 %zu 次（k=4，平均返回 %.2f 条）: p50=%.2f us  p99=%.2f us  max=%.2f us\n",
+                queries, static_cast<double>(found) / queries,
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back());
+    
+    std::remove(path.c_str());
+    return 0;
+}
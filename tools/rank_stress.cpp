@@ -0,0 +1,156 @@
+// 排行榜并发压力测试：多个写线程持续插入/更新，若干读线程以60Hz读取快照
+// 用法: ./bin/rank_stress [写线程数=8] [读线程数=2] [秒数=3] [初始记录数=100000]
+// 最后检查两个实例共用同一文件时，一方压缩重写主文件后另一方未落盘的日榜记录不丢失
+#include "RankList.h"
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+bool hasEntry(const std::vector<RankEntryView>& entries, const std::string& name, int score) {
+    for (const auto& entry : entries) {
+        if (entry.username == name && entry.score == score) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A 记录 alice 后未保存；B 记录 bob 并压缩（替换主文件）；A 随后重新加载时不能丢掉 alice 的日榜记录
+bool checkTwoInstances() {
+    char dir[] = "/tmp/rank_stressXXXXXX";
+    if (!::mkdtemp(dir)) {
+        return false;
+    }
+    std::string path = std::string(dir) + "/ranks.txt";
+    
+    bool ok = true;
+    {
+        RankList a(path);
+        RankList b(path);
+        a.load();
+        b.load();
+        a.insertOrUpdate("alice", 100);
+        b.insertOrUpdate("bob", 50);
+        b.compact();
+        a.refreshIfChanged();
+        
+        std::vector<RankEntryView> daily;
+        auto snap = a.snapshot();  // 名字是快照内的视图，比较完之前保持快照
+        snap->getPeriodTop(RankPeriod::DAILY, daily);
+        ok = ok && hasEntry(daily, "alice", 100) && hasEntry(daily, "bob", 50);
+        
+        // 保存后从文件重新加载的第三个实例也应看到两人
+        a.save();
+        RankList c(path);
+        c.load();
+        snap = c.snapshot();
+        snap->getPeriodTop(RankPeriod::DAILY, daily);
+        ok = ok && hasEntry(daily, "alice", 100) && hasEntry(daily, "bob", 50) &&
+             c.getUserScore("alice") == 100 && c.getUserScore("bob") == 50;
+    }
+    
+    for (const char* suffix : {"", ".log", ".periods", ".lock"}) {
+        std::remove((path + suffix).c_str());
+    }
+    ::rmdir(dir);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int writers = argc > 1 ? std::atoi(argv[1]) : 8;
+    int readers = argc > 2 ? std::atoi(argv[2]) : 2;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 3;
+    int initial = argc > 4 ? std::atoi(argv[4]) : 100000;
+    
+    // 只测内存中的并发读写，不落盘
+    RankList rankList("/dev/null");
+    std::vector<std::pair<std::string, int>> seed;
+    seed.reserve(initial);
+    for (int i = 0; i < initial; ++i) {
+        seed.push_back({"seed" + std::to_string(i), std::rand() % 100000});
+    }
+    rankList.insertOrUpdateBatch(seed);
+    
+    std::atomic<bool> running(true);
+    std::atomic<long long> writes(0);
+    std::vector<std::thread> threads;
+    
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            unsigned state = 12345u + w;
+            long long local = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                state = state * 1103515245u + 12345u;
+                rankList.insertOrUpdate("w" + std::to_string(w) + "_" + std::to_string(state % 5000),
+                                        static_cast<int>(state % 200000));
+                ++local;
+            }
+            writes += local;
+        });
+    }
+    
+    // 读线程模拟渲染：每帧取快照并读取一屏（10行），记录耗时
+    std::vector<std::vector<double>> latencies(readers);
+    std::atomic<long long> versionsSeen(0);
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            std::vector<RankEntryView> page;
+            uint64_t lastVersion = 0;
+            auto nextFrame = Clock::now();
+            while (running.load(std::memory_order_relaxed)) {
+                auto start = Clock::now();
+                auto snap = rankList.snapshot();
+                snap->getPage(snap->size() / 2, 10, page);
+                volatile int sink = snap->getBestScore() + (page.empty() ? 0 : page[0].score);
+                (void)sink;
+                latencies[r].push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                
+                if (snap->version() != lastVersion) {
+                    lastVersion = snap->version();
+                    ++versionsSeen;
+                }
+                
+                nextFrame += std::chrono::microseconds(16667);
+                std::this_thread::sleep_until(nextFrame);
+            }
+        });
+    }
+    
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    std::vector<double> all;
+    for (const auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    std::sort(all.begin(), all.end());
+    
+    auto pct = [&](double p) {
+        return all.empty() ? 0.0 : all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+    };
+    
+    std::printf("写线程: %d  读线程: %d  时长: %ds  记录数: %zu\n",
+                writers, readers, seconds, rankList.size());
+    std::printf("写入: %lld 次 (%.0f 次/秒)\n", writes.load(), writes.load() / static_cast<double>(seconds));
+    std::printf("读取帧: %zu  看到的快照版本数: %lld\n", all.size(), versionsSeen.load());
+    std::printf("读取耗时(us): p50=%.2f  p99=%.2f  max=%.2f\n", pct(0.5), pct(0.99), pct(1.0));
+    
+    bool twoInstances = checkTwoInstances();
+    std::printf("双实例时段榜合并: %s\n", twoInstances ? "通过" : "失败");
+    return twoInstances ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+// 回放批量分析：多线程内存映射读取目录下所有 .rpl 回放，经 Board 逐步重放并汇总统计
+// 统计内容：方向频率、合并率、空格数随步数的变化、对局结束时的步数/最大方块分布
+// 用法: ./bin/replay_analyze [目录=replays] [线程数=CPU核数]
+#include "Board.h"
+#include "MappedFile.h"
+#include "Replay.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const size_t kTimeBucket = 100;    // 空格数按每100步一个桶统计
+const size_t kTimeBuckets = 100;   // 超过的步数归入最后一个桶
+const size_t kLengthBucket = 250;  // 对局长度按250步分桶
+const size_t kLengthBuckets = 40;
+
+struct ReplayStats {
+    uint64_t files = 0;
+    uint64_t failed = 0;
+    uint64_t bytes = 0;
+    uint64_t moves = 0;
+    uint64_t directions[4] = {};
+    uint64_t merges = 0;            // 合并总次数
+    uint64_t movesWithMerge = 0;    // 至少有一次合并的步数
+    uint64_t finalScore = 0;
+    uint64_t endTile[18] = {};      // 结束时最大方块（log2）
+    uint64_t endEmpty[17] = {};     // 结束时空格数（正常结束应为0）
+    std::vector<uint64_t> emptySum = std::vector<uint64_t>(kTimeBuckets, 0);
+    std::vector<uint64_t> emptyCount = std::vector<uint64_t>(kTimeBuckets, 0);
+    std::vector<uint64_t> lengths = std::vector<uint64_t>(kLengthBuckets, 0);
+    
+    void merge(const ReplayStats& other) {
+        files += other.files;
+        failed += other.failed;
+        bytes += other.bytes;
+        moves += other.moves;
+        merges += other.merges;
+        movesWithMerge += other.movesWithMerge;
+        finalScore += other.finalScore;
+        for (int i = 0; i < 4; ++i) directions[i] += other.directions[i];
+        for (int i = 0; i < 18; ++i) endTile[i] += other.endTile[i];
+        for (int i = 0; i < 17; ++i) endEmpty[i] += other.endEmpty[i];
+        for (size_t i = 0; i < kTimeBuckets; ++i) {
+            emptySum[i] += other.emptySum[i];
+            emptyCount[i] += other.emptyCount[i];
+        }
+        for (size_t i = 0; i < kLengthBuckets; ++i) lengths[i] += other.lengths[i];
+    }
+};
+
+int countTiles(const int grid[4][4]) {
+    int count = 0;
+    for (int i = 0; i < 16; ++i) {
+        count += grid[i / 4][i % 4] != 0;
+    }
+    return count;
+}
+
+int tileLog2(int value) {
+    int log = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++log;
+    }
+    return std::min(log, 17);
+}
+
+// 重放一局并累计统计；回放无效返回false，且不计入任何统计（先记在本局的统计里，验证通过才合并）
+bool analyze(const Replay& replay, ReplayStats& stats) {
+    ReplayStats game;
+    Board board;
+    replay.startBoard(board);
+    
+    int grid[4][4];
+    board.getGrid(grid);
+    int tiles = countTiles(grid);
+    
+    for (size_t i = 0; i < replay.moveCount(); ++i) {
+        Direction dir = replay.moveAt(i);
+        MoveResult result = board.simulateMove(dir);
+        if (!result.changed) {
+            return false;
+        }
+        
+        // 合并次数 = 移动前后方块数之差
+        int merged = tiles - countTiles(result.grid);
+        game.merges += static_cast<uint64_t>(merged);
+        game.movesWithMerge += merged > 0;
+        ++game.directions[static_cast<int>(dir)];
+        
+        board.commitGrid(result.grid);
+        board.addScore(result.scoreGain);
+        board.spawnNewTile();
+        tiles = tiles - merged + 1;
+        
+        size_t bucket = std::min(i / kTimeBucket, kTimeBuckets - 1);
+        game.emptySum[bucket] += static_cast<uint64_t>(16 - tiles);
+        ++game.emptyCount[bucket];
+    }
+    
+    game.moves += replay.moveCount();
+    game.finalScore += static_cast<uint64_t>(board.getScore());
+    ++game.endTile[tileLog2(board.getMaxTile())];
+    ++game.endEmpty[16 - tiles];
+    ++game.lengths[std::min(replay.moveCount() / kLengthBucket, kLengthBuckets - 1)];
+    stats.merge(game);
+    return true;
+}
+
+// 分桶标签："100-199步"，最后一个桶为 "9900+步"
+std::string bucketLabel(size_t index, size_t width, size_t count) {
+    char label[32];
+    if (index + 1 == count) {
+        std::snprintf(label, sizeof(label), "%11zu+步", index * width);
+    } else {
+        std::snprintf(label, sizeof(label), "%5zu-%5zu步", index * width, (index + 1) * width - 1);
+    }
+    return label;
+}
+
+double percent(uint64_t part, uint64_t total) {
+    return total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string directory = argc > 1 ? argv[1] : "replays";
+    unsigned threadCount = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                                    : std::max(1u, std::thread::hardware_concurrency());
+    
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".rpl") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    if (ec) {
+        std::fprintf(stderr, "无法读取目录: %s\n", directory.c_str());
+        return 1;
+    }
+    
+    // 工作线程按原子下标领取文件，各自累计统计，最后合并（无共享写）
+    auto start = Clock::now();
+    std::atomic<size_t> next(0);
+    std::vector<ReplayStats> partial(threadCount);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            ReplayStats& stats = partial[t];
+            Replay replay;
+            MappedFile file;
+            for (size_t i = next++; i < paths.size(); i = next++) {
+                ++stats.files;
+                if (!file.open(paths[i]) || !replay.decode(file.data(), file.size()) || !analyze(replay, stats)) {
+                    ++stats.failed;
+                    continue;
+                }
+                stats.bytes += file.size();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    ReplayStats total;
+    for (const auto& stats : partial) {
+        total.merge(stats);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    uint64_t games = total.files - total.failed;
+    std::printf("回放: %llu 个（失败 %llu）  线程: %u  耗时: %.3f s\n",
+                static_cast<unsigned long long>(total.files), static_cast<unsigned long long>(total.failed),
+                threadCount, seconds);
+    std::printf("读取: %.2f MB (%.1f MB/s)  重放: %llu 步 (%.2f 百万步/秒)\n",
+                total.bytes / 1e6, total.bytes / 1e6 / seconds,
+                static_cast<unsigned long long>(total.moves), total.moves / 1e6 / seconds);
+    if (games == 0) {
+        return 0;
+    }
+    
+    std::printf("\n平均每局: %.1f 步  %.1f 分\n", static_cast<double>(total.moves) / games,
+                static_cast<double>(total.finalScore) / games);
+    std::printf("方向频率: 上 %.1f%%  下 %.1f%%  左 %.1f%%  右 %.1f%%\n",
+                percent(total.directions[0], total.moves), percent(total.directions[1], total.moves),
+                percent(total.directions[2], total.moves), percent(total.directions[3], total.moves));
+    std::printf("合并率: 每步 %.3f 次合并，%.1f%% 的步数至少有一次合并\n",
+                static_cast<double>(total.merges) / std::max<uint64_t>(total.moves, 1),
+                percent(total.movesWithMerge, total.moves));
+    
+    std::printf("\n平均空格数（按步数）:\n");
+    for (size_t i = 0; i < kTimeBuckets; ++i) {
+        if (total.emptyCount[i] == 0) continue;
+        std::printf("  %s: %5.2f  (%llu 步)\n", bucketLabel(i, kTimeBucket, kTimeBuckets).c_str(),
+                    static_cast<double>(total.emptySum[i]) / total.emptyCount[i],
+                    static_cast<unsigned long long>(total.emptyCount[i]));
+    }
+    
+    std::printf("\n对局结束时的步数:\n");
+    for (size_t i = 0; i < kLengthBuckets; ++i) {
+        if (total.lengths[i] == 0) continue;
+        std::printf("  %s: %llu 局 (%.1f%%)\n", bucketLabel(i, kLengthBucket, kLengthBuckets).c_str(),
+                    static_cast<unsigned long long>(total.lengths[i]), percent(total.lengths[i], games));
+    }
+    
+    std::printf("\n对局结束时的最大方块:\n");
+    for (int i = 1; i < 18; ++i) {
+        if (total.endTile[i] == 0) continue;
+        std::printf("  %6d: %llu 局 (%.1f%%)\n", 1 << i, static_cast<unsigned long long>(total.endTile[i]),
+                    percent(total.endTile[i], games));
+    }
+    
+    uint64_t unfinished = games - total.endEmpty[0];
+    if (unfinished > 0) {
+        std::printf("\n未到无路可走就结束的对局（结束时仍有空格）: %llu\n", static_cast<unsigned long long>(unfinished));
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+// 回放编解码基准：随机策略打N局并录制回放，编码后再逐局解码回放，校验最终局面并测量解码速度
+// 用法: ./bin/replay_bench [局数=2000]
+#include "Board.h"
+#include "Replay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t games = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    
+    std::mt19937 rng(42);
+    std::vector<std::vector<char>> encoded;
+    std::vector<int> finalScores;
+    encoded.reserve(games);
+    size_t totalMoves = 0;
+    size_t totalBytes = 0;
+    
+    // 录制：随机选择方向，直到无法移动
+    for (size_t g = 0; g < games; ++g) {
+        Board board;
+        board.init(rng());
+        Replay replay;
+        replay.begin("bench", board);
+        
+        while (!board.isGameOver()) {
+            Direction dir = static_cast<Direction>(rng() % 4);
+            if (board.applyMove(dir)) {
+                replay.append(dir);
+            }
+        }
+        
+        replay.finish(board.getScore(), 0);
+        encoded.push_back(replay.encode());
+        finalScores.push_back(board.getScore());
+        totalMoves += replay.moveCount();
+        totalBytes += encoded.back().size();
+    }
+    
+    std::printf("局数: %zu  总步数: %zu  平均每局 %.1f 步\n", games, totalMoves,
+                static_cast<double>(totalMoves) / games);
+    std::printf("回放总大小: %zu 字节  平均每步 %.3f 字节（20000步约 %.1f KB）\n", totalBytes,
+                static_cast<double>(totalBytes) / totalMoves, (46.0 + 20000 / 4.0) / 1024.0);
+    
+    // 解码：从种子重建所有新方块，校验最终分数
+    auto start = Clock::now();
+    size_t mismatches = 0;
+    Replay replay;
+    Board board;
+    for (size_t g = 0; g < games; ++g) {
+        if (!replay.decode(encoded[g].data(), encoded[g].size()) || !replay.play(board) ||
+            board.getScore() != finalScores[g] || !board.isGameOver()) {
+            ++mismatches;
+        }
+    }
+    double ms = elapsedMs(start);
+    
+    std::printf("解码回放: %.1f ms  %.2f 百万步/秒  不一致: %zu\n", ms, totalMoves / ms / 1000.0, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// 小棋盘精确求解：枚举 行x列 棋盘的所有可达局面，动态规划求最优策略的期望最终得分，
+// 同时给出贪心策略和随机策略的精确期望，作为启发式AI的参照；最后按最优策略模拟若干局核对
+// 加 batch 时正向展开用 BoardBatch 批量移动并与 movePacked 逐个核对（移动内核的压力测试）
+// 用法: ./bin/small_solver [行=3] [列=3] [线程数=1] [工作目录=solver] [batch] [模拟局数=1000]
+#include "Board.h"
+#include "SmallSolver.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+// 在区域内的空格中均匀选一格，0.9 为2、0.1 为4
+static uint64_t spawnInRegion(uint64_t board, int rows, int cols, std::mt19937_64& rng) {
+    int cells[16];
+    int count = 0;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (((board >> (4 * (row * 4 + col))) & 0xf) == 0) {
+                cells[count++] = row * 4 + col;
+            }
+        }
+    }
+    if (count == 0) {
+        return board;
+    }
+    int cell = cells[rng() % count];
+    uint64_t tile = rng() % 10 == 0 ? 2 : 1;
+    return board | (tile << (4 * cell));
+}
+
+int main(int argc, char* argv[]) {
+    int rows = argc > 1 ? std::atoi(argv[1]) : 3;
+    int cols = argc > 2 ? std::atoi(argv[2]) : 3;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+    std::string workDir = argc > 4 ? argv[4] : "solver";
+    bool useBatch = argc > 5 && std::strcmp(argv[5], "batch") == 0;
+    int games = argc > 6 ? std::atoi(argv[6]) : 1000;
+    
+    SmallSolver solver(rows, cols);
+    if (!solver.isValid()) {
+        std::fprintf(stderr, "不支持 %dx%d（行列为2~4，格子数不超过12）\n", rows, cols);
+        return 1;
+    }
+    solver.setThreads(threads);
+    solver.setWorkDir(workDir);
+    solver.setUseBatch(useBatch);
+    
+    std::printf("%dx%d  线程=%d  工作目录=%s  移动内核: %s\n", rows, cols, threads, workDir.c_str(),
+                useBatch ? "BoardBatch（与 movePacked 核对）" : "movePacked");
+    SmallSolverResult result;
+    if (!solver.run(result)) {
+        std::fprintf(stderr, "求解失败（工作目录无法写入或展开结果不一致）\n");
+        return 1;
+    }
+    
+    std::printf("可达局面: %llu（按对称合并） 层数: %d  最大一层: %llu\n",
+                static_cast<unsigned long long>(result.states), result.layers,
+                static_cast<unsigned long long>(result.largestLayer));
+    std::printf("正向展开: %.2f 秒  移动 %.2f 百万次（%.2f 百万次/秒）  内核不一致: %llu\n",
+                result.expandSeconds, result.moves / 1e6, result.moves / result.expandSeconds / 1e6,
+                static_cast<unsigned long long>(result.kernelMismatches));
+    std::printf("反向求值: %.2f 秒\n", result.solveSeconds);
+    std::printf("期望最终得分  最优: %.3f  贪心: %.3f  随机: %.3f\n",
+                result.optimalScore, result.greedyScore, result.randomScore);
+    
+    // 按最优策略模拟，平均得分应接近精确期望
+    std::mt19937_64 rng(2048);
+    double total = 0.0;
+    int maxTile = 0;
+    for (int g = 0; g < games; ++g) {
+        uint64_t board = spawnInRegion(spawnInRegion(0, rows, cols, rng), rows, cols, rng);
+        int score = 0;
+        Direction dir;
+        while (solver.bestMove(board, dir)) {
+            int gain = 0;
+            board = spawnInRegion(solver.move(board, dir, &gain), rows, cols, rng);
+            score += gain;
+        }
+        for (int i = 0; i < 16; ++i) {
+            maxTile = std::max(maxTile, static_cast<int>((board >> (4 * i)) & 0xf));
+        }
+        total += score;
+    }
+    if (games > 0) {
+        std::printf("最优策略模拟 %d 局: 平均 %.1f  最大方块 %d\n", games, total / games, 1 << maxTile);
+    }
+    return result.kernelMismatches == 0 ? 0 : 1;
+}
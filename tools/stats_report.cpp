@@ -0,0 +1,60 @@
+// 玩家统计汇总报表：映射 stats.bin，逐列扫描输出总体数据、最大方块分布和局数最多的玩家
+// 用法: ./bin/stats_report [统计文件=stats.bin] [列出前N名=10]
+#include "PlayerStats.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "stats.bin";
+    size_t topCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+    
+    PlayerStats stats(path);
+    if (!stats.open()) {
+        std::fprintf(stderr, "无法打开统计文件: %s\n", path.c_str());
+        return 1;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    PlayerStatSummary summary = stats.summarize();
+    double scanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    std::printf("玩家数: %u  总局数: %llu  扫描耗时: %.2f ms\n", summary.players,
+                static_cast<unsigned long long>(summary.gamesPlayed), scanMs);
+    if (summary.gamesPlayed > 0) {
+        std::printf("平均分: %.1f  平均步数: %.1f  最大方块: %u\n",
+                    static_cast<double>(summary.totalScore) / summary.gamesPlayed,
+                    static_cast<double>(summary.totalMoves) / summary.gamesPlayed, summary.maxTile);
+    }
+    
+    std::printf("最大方块分布:\n");
+    for (int log = 1; log < 18; ++log) {
+        if (summary.playersByMaxTile[log] > 0) {
+            std::printf("  %6d: %u\n", 1 << log, summary.playersByMaxTile[log]);
+        }
+    }
+    
+    // 按局数排序（只排下标，列数组本身不动）
+    std::vector<uint32_t> order(summary.players);
+    std::iota(order.begin(), order.end(), 0u);
+    const uint32_t* games = stats.gamesColumn();
+    size_t shown = std::min(topCount, order.size());
+    std::partial_sort(order.begin(), order.begin() + shown, order.end(),
+                      [games](uint32_t a, uint32_t b) { return games[a] > games[b]; });
+    
+    std::printf("局数最多的玩家:\n");
+    for (size_t i = 0; i < shown; ++i) {
+        uint32_t id = order[i];
+        std::string_view name = stats.nameOf(id);
+        std::printf("  %2zu. %-16.*s 局数 %-6u 平均分 %-8.1f 最高分 %-7u 最大方块 %u\n", i + 1,
+                    static_cast<int>(name.size()), name.data(), games[id],
+                    games[id] ? static_cast<double>(stats.totalScoreColumn()[id]) / games[id] : 0.0,
+                    stats.bestScoreColumn()[id], stats.maxTileColumn()[id]);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,197 @@
+// 策略锦标赛：M 个策略 x N 局，fork 出多个工作进程并行对局
+// 结果写入 fork 前创建的共享内存数组（每局一个槽位，各进程写不同的槽位，不加锁），
+// 每个进程另有一个独占缓存行的完成计数，父进程定时读取打印进度；全部结束后汇总成对比表
+// 第 g 局对所有策略使用同一个种子（由基础种子和局号算出），结果与进程数无关，可以复现
+// 用法: ./bin/tournament [局数=1000] [策略列表=greedy,corner,search] [进程数=CPU核数] [种子=2048]
+//       策略名见 makePolicy：greedy corner random search search3 ntuple（需要 ntuple.bin）
+#include "Board.h"
+#include "NTupleNetwork.h"
+#include "Policy.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// 一局的结果槽位；done 最后写，父进程看到 done 才读其余字段
+struct ResultSlot {
+    int32_t score;
+    int32_t moves;
+    int32_t maxTile;
+    std::atomic<uint32_t> done;
+};
+
+// 每个工作进程的进度计数，独占一条缓存行，避免进程间的伪共享
+struct alignas(64) WorkerProgress {
+    std::atomic<uint64_t> finished;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "跨进程共享内存中的原子变量必须无锁");
+
+const int kProgressIntervalMs = 500;
+
+uint64_t gameSeed(uint64_t baseSeed, int game) {
+    // splitmix64 的一步：相邻局号的种子互不相关
+    uint64_t z = baseSeed + 0x9E3779B97F4A7C15ULL * (game + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 工作进程：按 任务号 ≡ 进程号 (mod 进程数) 领取任务，每个任务新建策略（结果不受任务分配影响）
+void runWorker(int worker, int workers, const std::vector<std::string>& names, int games, uint64_t baseSeed,
+               const NTupleNetwork* network, ResultSlot* slots, WorkerProgress* progress) {
+    size_t total = names.size() * static_cast<size_t>(games);
+    for (size_t task = worker; task < total; task += workers) {
+        size_t strategy = task / games;
+        int game = static_cast<int>(task % games);
+        AnyPolicy policy = makePolicy(names[strategy], network);
+        GameOutcome outcome = playGame(policy, gameSeed(baseSeed, game));
+        
+        ResultSlot& slot = slots[task];
+        slot.score = outcome.score;
+        slot.moves = outcome.moves;
+        slot.maxTile = outcome.maxTile;
+        slot.done.store(1, std::memory_order_release);
+        progress[worker].finished.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+double percentile(const std::vector<int>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double rank = p * (sorted.size() - 1);
+    size_t low = static_cast<size_t>(rank);
+    size_t high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (sorted[high] - sorted[low]) * (rank - low);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int games = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+    std::string list = argc > 2 ? argv[2] : "greedy,corner,search";
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = argc > 3 ? std::max(1, std::atoi(argv[3])) : static_cast<int>(std::max(1L, cores));
+    uint64_t baseSeed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 2048;
+    
+    // 网络在 fork 前只读映射，各进程共享同一份物理页
+    NTupleNetwork network;
+    const NTupleNetwork* evaluator = network.open("ntuple.bin") ? &network : nullptr;
+    
+    std::vector<std::string> names;
+    std::stringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        if (!makePolicy(name, evaluator)) {
+            std::fprintf(stderr, "未知策略或缺少 ntuple.bin: %s\n", name.c_str());
+            return 1;
+        }
+        names.push_back(name);
+    }
+    if (names.empty()) {
+        return 1;
+    }
+    
+    size_t total = names.size() * static_cast<size_t>(games);
+    size_t bytes = total * sizeof(ResultSlot) + workers * sizeof(WorkerProgress);
+    void* shared = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+    // 匿名映射初始为全零，原子变量的零值即初始状态
+    WorkerProgress* progress = static_cast<WorkerProgress*>(shared);
+    ResultSlot* slots = reinterpret_cast<ResultSlot*>(progress + workers);
+    
+    std::printf("策略 %zu 个 x %d 局  进程: %d（CPU %ld）  种子: %llu  估值网络: %s\n", names.size(), games, workers,
+                cores, static_cast<unsigned long long>(baseSeed), evaluator ? "ntuple.bin" : "无");
+    std::fflush(stdout);   // fork 前清空缓冲，子进程不会重复输出
+    
+    auto start = Clock::now();
+    std::vector<pid_t> children;
+    for (int w = 0; w < workers; ++w) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            runWorker(w, workers, names, games, baseSeed, evaluator, slots, progress);
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+    
+    // 父进程：定时汇总各进程的计数打印进度，直到所有子进程退出
+    size_t running = children.size();
+    int failures = 0;
+    while (running > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kProgressIntervalMs));
+        int status;
+        pid_t pid;
+        while (running > 0 && (pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            --running;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                ++failures;
+            }
+        }
+        uint64_t finished = 0;
+        for (int w = 0; w < workers; ++w) {
+            finished += progress[w].finished.load(std::memory_order_relaxed);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::printf("\r已完成 %llu / %zu 局（%.1f%%）  %.1f 局/秒   ", static_cast<unsigned long long>(finished), total,
+                    100.0 * finished / total, finished / seconds);
+        std::fflush(stdout);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("\n用时 %.2f 秒\n\n", seconds);
+    
+    // 汇总：每个策略的平均、中位数、分位数和达到 2048/4096/8192 的比例
+    std::printf("策略                 局数      平均    中位数       P10       P90       P99    2048    4096    8192 平均步数\n");
+    size_t missing = 0;
+    for (size_t s = 0; s < names.size(); ++s) {
+        std::vector<int> scores;
+        uint64_t moves = 0;
+        int reached[3] = {0, 0, 0};
+        double sum = 0.0;
+        for (int g = 0; g < games; ++g) {
+            const ResultSlot& slot = slots[s * games + g];
+            if (slot.done.load(std::memory_order_acquire) == 0) {
+                ++missing;
+                continue;
+            }
+            scores.push_back(slot.score);
+            sum += slot.score;
+            moves += slot.moves;
+            for (int k = 0; k < 3; ++k) {
+                reached[k] += slot.maxTile >= (2048 << k) ? 1 : 0;
+            }
+        }
+        std::sort(scores.begin(), scores.end());
+        double count = scores.empty() ? 1.0 : static_cast<double>(scores.size());
+        AnyPolicy policy = makePolicy(names[s], evaluator);
+        std::printf("%-18s %6zu %9.1f %9.1f %9.1f %9.1f %9.1f %6.1f%% %6.1f%% %6.1f%% %8.1f\n", policy.name(),
+                    scores.size(), sum / count, percentile(scores, 0.5), percentile(scores, 0.1),
+                    percentile(scores, 0.9), percentile(scores, 0.99), 100.0 * reached[0] / count,
+                    100.0 * reached[1] / count, 100.0 * reached[2] / count, moves / count);
+    }
+    if (missing > 0 || failures > 0) {
+        std::printf("\n%zu 局没有结果（%d 个进程异常退出）\n", missing, failures);
+    }
+    
+    munmap(shared, bytes);
+    return missing == 0 && failures == 0 ? 0 : 1;
+}